@@ -0,0 +1,333 @@
+#include "BorderGeometryBatch.h"
+
+#include "ComputedStyle.h"
+#include <math.h>
+
+// The 8-lane path needs AVX2: with AVX alone, compilers turn some of the float
+// compares into 256-bit integer ops and then emulate those a lane at a time.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BORDER_GEOMETRY_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+#define BORDER_GEOMETRY_SSE2 1
+#endif
+
+namespace blink {
+
+namespace {
+
+// The kernel below is written once against these lane types. Each provides the same
+// handful of operations, and every lane type gives bit-identical results.
+struct ScalarLanes {
+    typedef float Value;
+    typedef bool Mask;
+    static const size_t count = 1;
+
+    static Value load(const float* p) { return *p; }
+    static void store(float* p, Value v) { *p = v; }
+    static Value splat(float f) { return f; }
+    static Value add(Value a, Value b) { return a + b; }
+    static Value sub(Value a, Value b) { return a - b; }
+    static Value mul(Value a, Value b) { return a * b; }
+    static Value div(Value a, Value b) { return a / b; }
+    static Value abs(Value a) { return fabsf(a); }
+    static Value floor(Value a) { return floorf(a); }
+    static Mask greaterThan(Value a, Value b) { return a > b; }
+    static Mask greaterOrEqual(Value a, Value b) { return a >= b; }
+    static Mask equal(Value a, Value b) { return a == b; }
+    static Mask notEqual(Value a, Value b) { return a != b; }
+    static Mask maskOr(Mask a, Mask b) { return a || b; }
+    static Value select(Mask m, Value a, Value b) { return m ? a : b; }
+};
+
+#if BORDER_GEOMETRY_SSE2
+struct SSE2Lanes {
+    typedef __m128 Value;
+    typedef __m128 Mask;
+    static const size_t count = 4;
+
+    static Value load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Value v) { _mm_storeu_ps(p, v); }
+    static Value splat(float f) { return _mm_set1_ps(f); }
+    static Value add(Value a, Value b) { return _mm_add_ps(a, b); }
+    static Value sub(Value a, Value b) { return _mm_sub_ps(a, b); }
+    static Value mul(Value a, Value b) { return _mm_mul_ps(a, b); }
+    static Value div(Value a, Value b) { return _mm_div_ps(a, b); }
+    static Value abs(Value a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    static Value floor(Value a)
+    {
+#if defined(__SSE4_1__)
+        return _mm_floor_ps(a);
+#else
+        // Truncate, step down where that rounded up, and leave values that are too
+        // large to have a fraction alone.
+        Value truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+        truncated = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a), _mm_set1_ps(1)));
+        return select(_mm_cmplt_ps(abs(a), _mm_set1_ps(8388608.f)), truncated, a);
+#endif
+    }
+    static Mask greaterThan(Value a, Value b) { return _mm_cmpgt_ps(a, b); }
+    static Mask greaterOrEqual(Value a, Value b) { return _mm_cmpge_ps(a, b); }
+    static Mask equal(Value a, Value b) { return _mm_cmpeq_ps(a, b); }
+    static Mask notEqual(Value a, Value b) { return _mm_cmpneq_ps(a, b); }
+    static Mask maskOr(Mask a, Mask b) { return _mm_or_ps(a, b); }
+    static Value select(Mask m, Value a, Value b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+};
+#endif
+
+#if BORDER_GEOMETRY_AVX
+struct AVXLanes {
+    typedef __m256 Value;
+    typedef __m256 Mask;
+    static const size_t count = 8;
+
+    static Value load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, Value v) { _mm256_storeu_ps(p, v); }
+    static Value splat(float f) { return _mm256_set1_ps(f); }
+    static Value add(Value a, Value b) { return _mm256_add_ps(a, b); }
+    static Value sub(Value a, Value b) { return _mm256_sub_ps(a, b); }
+    static Value mul(Value a, Value b) { return _mm256_mul_ps(a, b); }
+    static Value div(Value a, Value b) { return _mm256_div_ps(a, b); }
+    static Value abs(Value a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    static Value floor(Value a) { return _mm256_floor_ps(a); }
+    static Mask greaterThan(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Mask greaterOrEqual(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    static Mask equal(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static Mask notEqual(Value a, Value b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+    static Mask maskOr(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+    static Value select(Mask m, Value a, Value b) { return _mm256_blendv_ps(b, a, m); }
+};
+#endif
+
+// std::min(a, b) and std::max(a, b).
+template <typename L>
+inline typename L::Value minOf(typename L::Value a, typename L::Value b)
+{
+    return L::select(L::greaterThan(a, b), b, a);
+}
+
+template <typename L>
+inline typename L::Value maxOf(typename L::Value a, typename L::Value b)
+{
+    return L::select(L::greaterThan(b, a), b, a);
+}
+
+// floor(v + .5) as snapSizeToPixel() computes it in double. Adding 0.5 in float can
+// round up, so this adds one to the floor when the fraction is at least a half
+// instead; both the fraction and the comparison are exact.
+template <typename L>
+inline typename L::Value roundHalfUp(typename L::Value v)
+{
+    const typename L::Value floored = L::floor(v);
+    return L::add(floored, L::select(L::greaterOrEqual(L::sub(v, floored), L::splat(0.5f)), L::splat(1), L::splat(0)));
+}
+
+// One axis of pixelSnappedIntRect(): roundf() of the location, clamped to the int
+// range, and snapSizeToPixel() of the size.
+template <typename L>
+inline void snapToPixels(typename L::Value location, typename L::Value size,
+    typename L::Value& snappedLocation, typename L::Value& snappedSize)
+{
+    typedef typename L::Value Value;
+    const Value zero = L::splat(0);
+
+    const Value magnitude = L::abs(location);
+    const Value wholePart = L::floor(magnitude);
+    const Value fraction = L::sub(magnitude, wholePart);
+    const typename L::Mask negative = L::greaterThan(zero, location);
+
+    // roundf() rounds halfway cases away from zero. Subtracting from zero also turns
+    // -0 into 0, as the round trip through int does.
+    Value rounded = L::add(wholePart, L::select(L::greaterOrEqual(fraction, L::splat(0.5f)), L::splat(1), zero));
+    rounded = L::select(negative, L::sub(zero, rounded), rounded);
+    snappedLocation = minOf<L>(maxOf<L>(rounded, L::splat(-2147483648.f)), L::splat(2147483648.f));
+
+    // modff() keeps the sign of the location.
+    const Value signedFraction = L::select(negative, L::sub(zero, fraction), fraction);
+    snappedSize = L::sub(roundHalfUp<L>(L::add(signedFraction, size)), roundHalfUp<L>(signedFraction));
+}
+
+typedef BorderGeometryBatch Batch;
+
+// Processes every lane of |blocks| in steps of L::count. Unused lanes at the end
+// of the last block hold zeros and are computed along with the rest.
+template <typename L>
+void computeLanes(Batch::Block* blocks, size_t blockCount)
+{
+    typedef typename L::Value Value;
+    typedef typename L::Mask Mask;
+
+    const Value zero = L::splat(0);
+    const Value one = L::splat(1);
+
+    for (size_t lane = 0; lane < blockCount * Batch::kLanes; lane += L::count) {
+        float (*fields)[Batch::kLanes] = blocks[lane / Batch::kLanes].fields;
+        const size_t i = lane % Batch::kLanes;
+
+        const Value x = L::load(&fields[Batch::BoxX][i]);
+        const Value y = L::load(&fields[Batch::BoxY][i]);
+        const Value boxWidth = L::load(&fields[Batch::BoxWidth][i]);
+        const Value boxHeight = L::load(&fields[Batch::BoxHeight][i]);
+        const Value top = L::load(&fields[Batch::TopWidth][i]);
+        const Value right = L::load(&fields[Batch::RightWidth][i]);
+        const Value bottom = L::load(&fields[Batch::BottomWidth][i]);
+        const Value left = L::load(&fields[Batch::LeftWidth][i]);
+        const Mask rounded = L::notEqual(L::load(&fields[Batch::Rounded][i]), zero);
+
+        // The outer rect, and the inner rect inset by the border widths.
+        Value rectX, rectY, rectWidth, rectHeight;
+        snapToPixels<L>(x, boxWidth, rectX, rectWidth);
+        snapToPixels<L>(y, boxHeight, rectY, rectHeight);
+        L::store(&fields[Batch::OuterX][i], rectX);
+        L::store(&fields[Batch::OuterY][i], rectY);
+        L::store(&fields[Batch::OuterWidth][i], rectWidth);
+        L::store(&fields[Batch::OuterHeight][i], rectHeight);
+
+        Value innerX, innerY, innerWidth, innerHeight;
+        snapToPixels<L>(L::add(x, left), L::sub(boxWidth, L::add(left, right)), innerX, innerWidth);
+        snapToPixels<L>(L::add(y, top), L::sub(boxHeight, L::add(top, bottom)), innerY, innerHeight);
+        L::store(&fields[Batch::InnerX][i], innerX);
+        L::store(&fields[Batch::InnerY][i], innerY);
+        L::store(&fields[Batch::InnerWidth][i], innerWidth);
+        L::store(&fields[Batch::InnerHeight][i], innerHeight);
+
+        // ComputedStyle::calcRadiiFor(): radii can't exceed the unsnapped box.
+        Value width[4];
+        Value height[4];
+        for (int corner = 0; corner < 4; ++corner) {
+            width[corner] = minOf<L>(L::load(&fields[Batch::TopLeftWidth + 2 * corner][i]), boxWidth);
+            height[corner] = minOf<L>(L::load(&fields[Batch::TopLeftHeight + 2 * corner][i]), boxHeight);
+        }
+
+        // calcBorderRadiiConstraintScaleFor(), corners in Radii order.
+        const Value sums[4] = {
+            L::add(width[0], width[1]),
+            L::add(width[2], width[3]),
+            L::add(height[0], height[2]),
+            L::add(height[1], height[3]),
+        };
+        Value factor = one;
+        for (int side = 0; side < 4; ++side) {
+            const Value length = side < 2 ? rectWidth : rectHeight;
+            factor = L::select(L::greaterThan(sums[side], length), minOf<L>(L::div(length, sums[side]), factor), factor);
+        }
+
+        // FloatRoundedRect::Radii::scaleAndFloor(), which does nothing for a factor of 1.
+        const Mask scaled = L::notEqual(factor, one);
+        for (int corner = 0; corner < 4; ++corner) {
+            Value scaledWidth = L::floor(L::mul(width[corner], factor));
+            Value scaledHeight = L::floor(L::mul(height[corner], factor));
+            const Mask empty = L::maskOr(L::equal(scaledWidth, zero), L::equal(scaledHeight, zero));
+            scaledWidth = L::select(empty, zero, scaledWidth);
+            scaledHeight = L::select(empty, zero, scaledHeight);
+            width[corner] = L::select(rounded, L::select(scaled, scaledWidth, width[corner]), zero);
+            height[corner] = L::select(rounded, L::select(scaled, scaledHeight, height[corner]), zero);
+        }
+
+        // FloatRoundedRect::Radii::shrink() by the border widths.
+        const Value horizontalInsets[4] = { left, right, left, right };
+        const Value verticalInsets[4] = { top, top, bottom, bottom };
+        for (int corner = 0; corner < 4; ++corner) {
+            L::store(&fields[Batch::OuterTopLeftWidth + 2 * corner][i], width[corner]);
+            L::store(&fields[Batch::OuterTopLeftHeight + 2 * corner][i], height[corner]);
+
+            const Value innerRadiusWidth = maxOf<L>(zero, L::sub(width[corner], horizontalInsets[corner]));
+            const Value innerRadiusHeight = maxOf<L>(zero, L::sub(height[corner], verticalInsets[corner]));
+            L::store(&fields[Batch::InnerTopLeftWidth + 2 * corner][i], L::select(rounded, innerRadiusWidth, zero));
+            L::store(&fields[Batch::InnerTopLeftHeight + 2 * corner][i], L::select(rounded, innerRadiusHeight, zero));
+        }
+    }
+}
+
+} // namespace
+
+void BorderGeometryBatch::clear()
+{
+    m_blocks.clear();
+    m_size = 0;
+}
+
+void BorderGeometryBatch::reserve(size_t count)
+{
+    m_blocks.reserve((count + kLanes - 1) / kLanes);
+}
+
+size_t BorderGeometryBatch::add(const LayoutRect& borderRect, const ComputedStyle& style)
+{
+    const ComputedStyle::BorderData& border = style.m_border;
+    const float inputs[] = {
+        borderRect.x(), borderRect.y(), borderRect.width(), borderRect.height(),
+        static_cast<float>(border.borderTopWidth()), static_cast<float>(border.borderRightWidth()),
+        static_cast<float>(border.borderBottomWidth()), static_cast<float>(border.borderLeftWidth()),
+        border.hasBorderRadius() ? 1.f : 0.f,
+        border.topLeft().width(), border.topLeft().height(),
+        border.topRight().width(), border.topRight().height(),
+        border.bottomLeft().width(), border.bottomLeft().height(),
+        border.bottomRight().width(), border.bottomRight().height(),
+    };
+    static_assert(sizeof(inputs) / sizeof(inputs[0]) == OuterX, "one value per input field");
+
+    const size_t index = m_size++;
+    if (index % kLanes == 0)
+        m_blocks.resize(m_blocks.size() + 1);
+    Block& block = m_blocks.back();
+    for (int field = 0; field < OuterX; ++field)
+        block.fields[field][index % kLanes] = inputs[field];
+    return index;
+}
+
+void BorderGeometryBatch::compute()
+{
+#if BORDER_GEOMETRY_AVX
+    computeLanes<AVXLanes>(m_blocks.data(), m_blocks.size());
+#elif BORDER_GEOMETRY_SSE2
+    computeLanes<SSE2Lanes>(m_blocks.data(), m_blocks.size());
+#else
+    computeLanes<ScalarLanes>(m_blocks.data(), m_blocks.size());
+#endif
+}
+
+void BorderGeometryBatch::computeScalar()
+{
+    computeLanes<ScalarLanes>(m_blocks.data(), m_blocks.size());
+}
+
+const char* BorderGeometryBatch::instructionSet()
+{
+#if BORDER_GEOMETRY_AVX
+    return "AVX2";
+#elif BORDER_GEOMETRY_SSE2 && defined(__SSE4_1__)
+    return "SSE4.1";
+#elif BORDER_GEOMETRY_SSE2
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+FloatRoundedRect::Radii BorderGeometryBatch::radii(int first, size_t index) const
+{
+    return FloatRoundedRect::Radii(
+        FloatSize(field(first, index), field(first + 1, index)),
+        FloatSize(field(first + 2, index), field(first + 3, index)),
+        FloatSize(field(first + 4, index), field(first + 5, index)),
+        FloatSize(field(first + 6, index), field(first + 7, index)));
+}
+
+FloatRoundedRect BorderGeometryBatch::outer(size_t index) const
+{
+    return FloatRoundedRect(FloatRect(field(OuterX, index), field(OuterY, index),
+        field(OuterWidth, index), field(OuterHeight, index)), radii(OuterTopLeftWidth, index));
+}
+
+FloatRoundedRect BorderGeometryBatch::inner(size_t index) const
+{
+    return FloatRoundedRect(FloatRect(field(InnerX, index), field(InnerY, index),
+        field(InnerWidth, index), field(InnerHeight, index)), radii(InnerTopLeftWidth, index));
+}
+
+} // namespace blink
@@ -0,0 +1,107 @@
+#ifndef BorderGeometryBatch_h
+#define BorderGeometryBatch_h
+
+#include "BorderEdge.h"
+#include "FloatRoundedRect.h"
+#include <vector>
+
+namespace blink {
+
+class ComputedStyle;
+
+// Computes the outer and inner rounded rects of many borders at once. The inputs and
+// results are stored as structure-of-arrays, so that pixel snapping and the clamping,
+// constraining and shrinking of the corner radii run on several borders per SIMD
+// instruction (8 borders with AVX2, 4 with SSE2, otherwise one at a time).
+//
+// The results are identical to ComputedStyle::getRoundedBorderFor() and
+// getRoundedInnerBorderFor() with both logical edges included, for any border box
+// whose snapped size fits in an int.
+class BorderGeometryBatch {
+public:
+    void clear();
+    void reserve(size_t);
+    size_t size() const { return m_size; }
+
+    // Returns the index of the border's results.
+    size_t add(const LayoutRect& borderRect, const ComputedStyle&);
+
+    // compute() uses the widest SIMD instructions the build targets, computeScalar()
+    // processes one border at a time and is there to measure and check against.
+    void compute();
+    void computeScalar();
+
+    // Name of the instructions compute() uses, for reports.
+    static const char* instructionSet();
+
+    FloatRoundedRect outer(size_t index) const;
+    FloatRoundedRect inner(size_t index) const;
+
+    enum Field {
+        // Inputs.
+        BoxX,
+        BoxY,
+        BoxWidth,
+        BoxHeight,
+        TopWidth,
+        RightWidth,
+        BottomWidth,
+        LeftWidth,
+        // 1 when the style has a border radius, 0 otherwise.
+        Rounded,
+        // Corner radii as specified by the style, in FloatRoundedRect::Radii order.
+        TopLeftWidth,
+        TopLeftHeight,
+        TopRightWidth,
+        TopRightHeight,
+        BottomLeftWidth,
+        BottomLeftHeight,
+        BottomRightWidth,
+        BottomRightHeight,
+        // Results, with the radii in the same order.
+        OuterX,
+        OuterY,
+        OuterWidth,
+        OuterHeight,
+        InnerX,
+        InnerY,
+        InnerWidth,
+        InnerHeight,
+        OuterTopLeftWidth,
+        OuterTopLeftHeight,
+        OuterTopRightWidth,
+        OuterTopRightHeight,
+        OuterBottomLeftWidth,
+        OuterBottomLeftHeight,
+        OuterBottomRightWidth,
+        OuterBottomRightHeight,
+        InnerTopLeftWidth,
+        InnerTopLeftHeight,
+        InnerTopRightWidth,
+        InnerTopRightHeight,
+        InnerBottomLeftWidth,
+        InnerBottomLeftHeight,
+        InnerBottomRightWidth,
+        InnerBottomRightHeight,
+        FieldCount
+    };
+
+    // Borders are stored in blocks of kLanes, each holding one row of kLanes values
+    // per field. This keeps add() on a few cache lines while still giving the kernel
+    // whole rows to load.
+    static const size_t kLanes = 8;
+    struct Block {
+        float fields[FieldCount][kLanes];
+    };
+
+private:
+    float field(int which, size_t index) const { return m_blocks[index / kLanes].fields[which][index % kLanes]; }
+    FloatRoundedRect::Radii radii(int first, size_t index) const;
+
+    std::vector<Block> m_blocks;
+    size_t m_size = 0;
+};
+
+} // namespace blink
+
+#endif // BorderGeometryBatch_h
@@ -11,6 +11,7 @@
 #include "LayoutRectOutsets.h"
 #include "ComputedStyle.h"
 #include "ObjectPainter.h"
+#include "PaintStats.h"
 #if 0
 #include "core/paint/BoxPainter.h"
 #include "core/paint/ObjectPainter.h"
@@ -365,10 +366,30 @@ const unsigned kSidePriority[] = {
 
 // Edges sharing the same opacity. Stores both a side list and an edge bitfield to support
 // constant time iteration + membership tests.
+// A border has at most four sides, so side lists are kept inline rather than on the heap.
+struct BoxSideList {
+    BoxSideList() : count(0) { }
+
+    void push_back(BoxSide side)
+    {
+        ASSERT(count < 4);
+        sides[count++] = side;
+    }
+    bool empty() const { return !count; }
+    unsigned size() const { return count; }
+    BoxSide& operator[](unsigned i) { return sides[i]; }
+    const BoxSide* begin() const { return sides; }
+    const BoxSide* end() const { return sides + count; }
+
+    BoxSide sides[4];
+    unsigned count;
+};
+
 struct OpacityGroup {
+    OpacityGroup() : edgeFlags(0), alpha(0) { }
     OpacityGroup(unsigned alpha) : edgeFlags(0), alpha(alpha) { }
 
-    vector<BoxSide> sides;
+    BoxSideList sides;
     BorderEdgeFlags edgeFlags;
     unsigned alpha;
 };
@@ -388,9 +409,10 @@ void clipQuad(GraphicsContext& context, const FloatPoint quad[], bool antialiase
 // Holds edges grouped by opacity and sorted in paint order.
 struct BoxBorderPainter::ComplexBorderInfo {
     ComplexBorderInfo(const BoxBorderPainter& borderPainter, bool antiAlias)
-        : antiAlias(antiAlias)
+        : opacityGroupCount(0)
+        , antiAlias(antiAlias)
     {
-        vector<BoxSide> sortedSides;
+        BoxSideList sortedSides;
 
         // First, collect all visible sides.
         for (unsigned i = borderPainter.m_firstVisibleEdge; i < 4; ++i) {
@@ -402,23 +424,18 @@ struct BoxBorderPainter::ComplexBorderInfo {
         ASSERT(!sortedSides.empty());
 
         // Then sort them in paint order, based on three (prioritized) criteria: alpha, style, side.
-        std::sort(sortedSides.begin(), sortedSides.end(),
-            [&borderPainter] (BoxSide a, BoxSide b) -> bool {
-            const BorderEdge& edgeA = borderPainter.m_edges[a];
-            const BorderEdge& edgeB = borderPainter.m_edges[b];
-
-            const unsigned alphaA = edgeA.color.alpha();
-            const unsigned alphaB = edgeB.color.alpha();
-            if (alphaA != alphaB)
-                return alphaA < alphaB;
-
-            const unsigned stylePriorityA = kStylePriority[edgeA.borderStyle()];
-            const unsigned stylePriorityB = kStylePriority[edgeB.borderStyle()];
-            if (stylePriorityA != stylePriorityB)
-                return stylePriorityA < stylePriorityB;
-
-            return kSidePriority[a] < kSidePriority[b];
-        });
+        // With at most four sides an optimal sorting network (five compare-exchanges) does the job;
+        // comparators that reach past the last side are skipped, which leaves a valid network for
+        // two or three sides.
+        static const unsigned kSortingNetwork[][2] = { { 0, 1 }, { 2, 3 }, { 0, 2 }, { 1, 3 }, { 1, 2 } };
+        for (const auto& comparator : kSortingNetwork) {
+            if (comparator[1] >= sortedSides.size())
+                continue;
+            BoxSide& a = sortedSides[comparator[0]];
+            BoxSide& b = sortedSides[comparator[1]];
+            if (paintsBefore(borderPainter, b, a))
+                std::swap(a, b);
+        }
 
         // Finally, build the opacity group structures.
         buildOpacityGroups(borderPainter, sortedSides);
@@ -427,7 +444,8 @@ struct BoxBorderPainter::ComplexBorderInfo {
             roundedBorderPath.addRRect(borderPainter.m_outer);
     }
 
-    vector<OpacityGroup> opacityGroups;
+    OpacityGroup opacityGroups[4];
+    unsigned opacityGroupCount;
 
     // Potentially used when drawing rounded borders.
     Path roundedBorderPath;
@@ -435,8 +453,26 @@ struct BoxBorderPainter::ComplexBorderInfo {
     bool antiAlias;
 
 private:
+    static bool paintsBefore(const BoxBorderPainter& borderPainter, BoxSide a, BoxSide b)
+    {
+        const BorderEdge& edgeA = borderPainter.m_edges[a];
+        const BorderEdge& edgeB = borderPainter.m_edges[b];
+
+        const unsigned alphaA = edgeA.color.alpha();
+        const unsigned alphaB = edgeB.color.alpha();
+        if (alphaA != alphaB)
+            return alphaA < alphaB;
+
+        const unsigned stylePriorityA = kStylePriority[edgeA.borderStyle()];
+        const unsigned stylePriorityB = kStylePriority[edgeB.borderStyle()];
+        if (stylePriorityA != stylePriorityB)
+            return stylePriorityA < stylePriorityB;
+
+        return kSidePriority[a] < kSidePriority[b];
+    }
+
     void buildOpacityGroups(const BoxBorderPainter& borderPainter,
-        const vector<BoxSide>& sortedSides)
+        const BoxSideList& sortedSides)
     {
         unsigned currentAlpha = 0;
         for (BoxSide side : sortedSides) {
@@ -446,17 +482,18 @@ private:
             ASSERT(edgeAlpha > 0);
             ASSERT(edgeAlpha >= currentAlpha);
             if (edgeAlpha != currentAlpha) {
-                opacityGroups.push_back(OpacityGroup(edgeAlpha));
+                ASSERT(opacityGroupCount < 4);
+                opacityGroups[opacityGroupCount++] = OpacityGroup(edgeAlpha);
                 currentAlpha = edgeAlpha;
             }
 
-            ASSERT(!opacityGroups.empty());
-            OpacityGroup& currentGroup = opacityGroups.back();
+            ASSERT(opacityGroupCount);
+            OpacityGroup& currentGroup = opacityGroups[opacityGroupCount - 1];
             currentGroup.sides.push_back(side);
             currentGroup.edgeFlags |= edgeFlagForSide(side);
         }
 
-        ASSERT(!opacityGroups.empty());
+        ASSERT(opacityGroupCount);
     }
 };
 
@@ -467,8 +504,6 @@ void BoxBorderPainter::drawDoubleBorder(GraphicsContext& context, const LayoutRe
     ASSERT(firstEdge().borderStyle() == BorderStyleDouble);
     ASSERT(m_visibleEdgeSet == AllBorderEdges);
 
-    assert(0);
-
     const Color color = firstEdge().color;
 
     // outer stripe
@@ -489,11 +524,23 @@ void BoxBorderPainter::drawDoubleBorder(GraphicsContext& context, const LayoutRe
 
 bool BoxBorderPainter::paintBorderFastPath(GraphicsContext& context, const LayoutRect& borderRect) const
 {
-    if (!m_isUniformColor || !m_isUniformStyle || !m_inner.isRenderable())
+    if (!m_isUniformColor) {
+        PaintStats::countBorderFallback(PaintStats::BorderNonUniformColor);
         return false;
+    }
+    if (!m_isUniformStyle) {
+        PaintStats::countBorderFallback(PaintStats::BorderNonUniformStyle);
+        return false;
+    }
+    if (!m_inner.isRenderable()) {
+        PaintStats::countBorderFallback(PaintStats::BorderInnerNotRenderable);
+        return false;
+    }
 
-    if (firstEdge().borderStyle() != BorderStyleSolid && firstEdge().borderStyle() != BorderStyleDouble)
+    if (firstEdge().borderStyle() != BorderStyleSolid && firstEdge().borderStyle() != BorderStyleDouble) {
+        PaintStats::countBorderFallback(PaintStats::BorderNonSolidStyle);
         return false;
+    }
 
     if (m_visibleEdgeSet == AllBorderEdges) {
         if (firstEdge().borderStyle() == BorderStyleSolid) {
@@ -510,6 +557,7 @@ bool BoxBorderPainter::paintBorderFastPath(GraphicsContext& context, const Layou
             drawDoubleBorder(context, borderRect);
         }
 
+        PaintStats::countBorderFastPath();
         return true;
     }
 
@@ -530,9 +578,11 @@ bool BoxBorderPainter::paintBorderFastPath(GraphicsContext& context, const Layou
 
         context.setFillColor(firstEdge().color);
         context.fillPath(path);
+        PaintStats::countBorderFastPath();
         return true;
     }
 
+    PaintStats::countBorderFallback(PaintStats::BorderPartialEdges);
     return false;
 }
 
@@ -565,6 +615,32 @@ BoxBorderPainter::BoxBorderPainter(const LayoutRect& borderRect, const ComputedS
     m_isRounded = m_outer.isRounded();
 }
 
+BoxBorderPainter::BoxBorderPainter(const ComputedStyle& style,
+    BackgroundBleedAvoidance bleedAvoidance, const FloatRoundedRect& outer,
+    const FloatRoundedRect& inner)
+    : m_style(style)
+    , m_bleedAvoidance(bleedAvoidance)
+    , m_includeLogicalLeftEdge(true)
+    , m_includeLogicalRightEdge(true)
+    , m_outer(outer)
+    , m_inner(inner)
+    , m_visibleEdgeCount(0)
+    , m_firstVisibleEdge(0)
+    , m_visibleEdgeSet(0)
+    , m_isUniformStyle(true)
+    , m_isUniformWidth(true)
+    , m_isUniformColor(true)
+    , m_isRounded(false)
+    , m_hasAlpha(false)
+{
+    style.getBorderEdgeInfo(m_edges, true, true);
+    computeBorderProperties();
+
+    if (!m_visibleEdgeSet)
+        return;
+    m_isRounded = m_outer.isRounded();
+}
+
 BoxBorderPainter::BoxBorderPainter(const ComputedStyle& style, const LayoutRect& outer,
     const LayoutRect& inner, const BorderEdge& uniformEdgeInfo)
     : m_style(style)
@@ -643,7 +719,9 @@ void BoxBorderPainter::paintBorder(const PaintInfo& info, const LayoutRect& rect
     }
 
     const ComplexBorderInfo borderInfo(*this, true);
+    graphicsContext.beginQuadBatch();
     paintOpacityGroup(graphicsContext, borderInfo, 0, 1);
+    graphicsContext.endQuadBatch();
 }
 
 // In order to maximize the use of overdraw as a corner seam avoidance technique, we draw
@@ -693,7 +771,7 @@ BorderEdgeFlags BoxBorderPainter::paintOpacityGroup(GraphicsContext& context,
 {
     ASSERT(effectiveOpacity > 0 && effectiveOpacity <= 1);
 
-    const size_t opacityGroupCount = borderInfo.opacityGroups.size();
+    const unsigned opacityGroupCount = borderInfo.opacityGroupCount;
 
     // For overdraw logic purposes, treat missing/transparent edges as completed.
     if (index >= opacityGroupCount)
@@ -711,7 +789,7 @@ BorderEdgeFlags BoxBorderPainter::paintOpacityGroup(GraphicsContext& context,
     // For the last (bottom) group, we can skip the layer even in the presence of opacity iff
     // it contains no adjecent edges (no in-group overdraw possibility).
     bool needsLayer = group.alpha != 255
-        && (includesAdjacentEdges(group.edgeFlags) || (index + 1 < borderInfo.opacityGroups.size()));
+        && (includesAdjacentEdges(group.edgeFlags) || (index + 1 < opacityGroupCount));
 
     if (needsLayer) {
         const float groupOpacity = static_cast<float>(group.alpha) / 255;
@@ -875,6 +953,13 @@ void BoxBorderPainter::paintOneBorderSide(GraphicsContext& graphicsContext,
         MiterType miter2 = computeMiter(side, adjacentSide2, completedEdges, antialias);
         bool shouldClip = mitersRequireClipping(miter1, miter2, edgeToRender.borderStyle(), antialias);
 
+        // Without rounded corners the miters are straight diagonals, so they can be drawn as
+        // polygons in their own AA mode instead of going through an anti-aliased clip.
+        if (shouldClip && !m_isRounded && !styleRequiresClipPolygon(edgeToRender.borderStyle())
+            && drawMiteredBoxSide(graphicsContext, sideRect, side, color, edgeToRender.borderStyle(),
+                miter1, adjacentEdge1.width, miter2, adjacentEdge2.width))
+            return;
+
         GraphicsContextStateSaver clipStateSaver(graphicsContext, shouldClip);
         if (shouldClip) {
             clipBorderSidePolygon(graphicsContext, side, miter1, miter2);
@@ -891,16 +976,81 @@ void BoxBorderPainter::paintOneBorderSide(GraphicsContext& graphicsContext,
     }
 }
 
-float PathLength(const SkPath& path)
+// Draws a side of a non-rounded border with its miters as polygon edges. When the two miters
+// need different AA modes the side is split in two at a pixel boundary, so the halves meet
+// without a seam. Returns false if the miters overlap, which still needs the clip.
+bool BoxBorderPainter::drawMiteredBoxSide(GraphicsContext& graphicsContext, const FloatRect& sideRect,
+    BoxSide side, Color color, EBorderStyle borderStyle, MiterType miter1, int adjacentWidth1,
+    MiterType miter2, int adjacentWidth2) const
 {
-        SkScalar length = 0;
-        SkPathMeasure measure(path, false);
+    ASSERT(!m_isRounded);
+
+    int x1 = sideRect.x();
+    int y1 = sideRect.y();
+    int x2 = sideRect.maxX();
+    int y2 = sideRect.maxY();
+    int width1 = miter1 != NoMiter ? adjacentWidth1 : 0;
+    int width2 = miter2 != NoMiter ? adjacentWidth2 : 0;
+
+    if (miter1 == NoMiter || miter2 == NoMiter || miter1 == miter2) {
+        bool antialias = (miter1 != NoMiter ? miter1 : miter2) == SoftMiter;
+        ObjectPainter::drawLineForBoxSide(graphicsContext, x1, y1, x2, y2, side, color, borderStyle,
+            width1, width2, antialias);
+        return true;
+    }
 
-        do {
-                length += measure.getLength();
-        } while (measure.nextContour());
+    if (side == BSTop || side == BSBottom) {
+        if (x1 + width1 > x2 - width2)
+            return false;
+        int split = (x1 + width1 + x2 - width2) / 2;
+        ObjectPainter::drawLineForBoxSide(graphicsContext, x1, y1, split, y2, side, color, borderStyle,
+            width1, 0, miter1 == SoftMiter);
+        ObjectPainter::drawLineForBoxSide(graphicsContext, split, y1, x2, y2, side, color, borderStyle,
+            0, width2, miter2 == SoftMiter);
+    } else {
+        if (y1 + width1 > y2 - width2)
+            return false;
+        int split = (y1 + width1 + y2 - width2) / 2;
+        ObjectPainter::drawLineForBoxSide(graphicsContext, x1, y1, x2, split, side, color, borderStyle,
+            width1, 0, miter1 == SoftMiter);
+        ObjectPainter::drawLineForBoxSide(graphicsContext, x1, split, x2, y2, side, color, borderStyle,
+            0, width2, miter2 == SoftMiter);
+    }
+    return true;
+}
 
-        return SkScalarToFloat(length);
+float PathLength(const SkPath& path)
+{
+    // Border paths are built from the outer rrect, whose length has a closed form.
+    SkRRect rrect;
+    SkRect rect;
+    if (path.isRRect(&rrect))
+        return FloatRoundedRect(rrect).perimeter();
+    if (path.isOval(&rect)) {
+        FloatSize radii(rect.width() / 2, rect.height() / 2);
+        return FloatRoundedRect(rect, radii, radii, radii, radii).perimeter();
+    }
+    if (path.isRect(&rect))
+        return 2 * (rect.width() + rect.height());
+
+    // Anything else needs a full SkPathMeasure pass; remember the last result since each side
+    // of a border asks for the same path.
+    static thread_local uint32_t cachedGenerationID = 0;
+    static thread_local float cachedLength = 0;
+    uint32_t generationID = path.getGenerationID();
+    if (cachedGenerationID && generationID == cachedGenerationID)
+        return cachedLength;
+
+    SkScalar length = 0;
+    SkPathMeasure measure(path, false);
+
+    do {
+        length += measure.getLength();
+    } while (measure.nextContour());
+
+    cachedGenerationID = generationID;
+    cachedLength = SkScalarToFloat(length);
+    return cachedLength;
 }
 
 void BoxBorderPainter::drawBoxSideFromPath(GraphicsContext& graphicsContext,
@@ -918,6 +1068,8 @@ void BoxBorderPainter::drawBoxSideFromPath(GraphicsContext& graphicsContext,
     case BorderStyleHidden:
         return;
     case BorderStyleDotted:
+        drawDottedRoundedBoxSide(graphicsContext, side, thickness, color);
+        return;
     case BorderStyleDashed: {
         graphicsContext.setStrokeColor(color);
 
@@ -1043,6 +1195,69 @@ void BoxBorderPainter::drawBoxSideFromPath(GraphicsContext& graphicsContext,
     graphicsContext.drawRect(pixelSnappedIntRect(borderRect));
 }
 
+static FloatPoint pointOnEllipse(const FloatPoint& center, const FloatSize& radii, float degrees)
+{
+    float radians = degrees * static_cast<float>(M_PI / 180);
+    return FloatPoint(center.x() + radii.width() * cosf(radians), center.y() + radii.height() * sinf(radians));
+}
+
+// Appends points along the elliptical arc between the two angles (in degrees, clockwise from
+// the positive x axis), including the end point but not the start point.
+static void appendArcPoints(vector<FloatPoint>& points, const FloatPoint& center, const FloatSize& radii,
+    float startAngle, float endAngle)
+{
+    const int kArcSegments = 8;
+    for (int i = 1; i <= kArcSegments; ++i)
+        points.push_back(pointOnEllipse(center, radii, startAngle + (endAngle - startAngle) * i / kArcSegments));
+}
+
+void BoxBorderPainter::drawDottedRoundedBoxSide(GraphicsContext& graphicsContext, BoxSide side,
+    float thickness, Color color) const
+{
+    // Dots run along the middle of the border area, from the middle of the corner arc that
+    // starts the side (going clockwise) to the middle of the arc that ends it.
+    float topInset = m_edges[BSTop].usedWidth() / 2.f;
+    float rightInset = m_edges[BSRight].usedWidth() / 2.f;
+    float bottomInset = m_edges[BSBottom].usedWidth() / 2.f;
+    float leftInset = m_edges[BSLeft].usedWidth() / 2.f;
+
+    const FloatRect& outerRect = m_outer.rect();
+    FloatRect centerRect(outerRect.x() + leftInset, outerRect.y() + topInset,
+        std::max(0.f, outerRect.width() - leftInset - rightInset),
+        std::max(0.f, outerRect.height() - topInset - bottomInset));
+    FloatRoundedRect::Radii radii = m_outer.getRadii();
+    radii.shrink(topInset, bottomInset, leftInset, rightInset);
+
+    // Corners in clockwise order starting at the top left, so that side N runs from corner N to
+    // corner N + 1. A corner that is square in either direction has no arc.
+    FloatSize cornerRadii[4] = { radii.topLeft(), radii.topRight(), radii.bottomRight(), radii.bottomLeft() };
+    for (auto& cornerRadius : cornerRadii) {
+        if (cornerRadius.isEmpty())
+            cornerRadius = FloatSize();
+    }
+    const FloatPoint cornerCenters[4] = {
+        FloatPoint(centerRect.x() + cornerRadii[0].width(), centerRect.y() + cornerRadii[0].height()),
+        FloatPoint(centerRect.maxX() - cornerRadii[1].width(), centerRect.y() + cornerRadii[1].height()),
+        FloatPoint(centerRect.maxX() - cornerRadii[2].width(), centerRect.maxY() - cornerRadii[2].height()),
+        FloatPoint(centerRect.x() + cornerRadii[3].width(), centerRect.maxY() - cornerRadii[3].height()),
+    };
+
+    // The arc of corner N sweeps from 180 + 90 * N degrees to 270 + 90 * N degrees.
+    unsigned startCorner = side;
+    unsigned endCorner = (side + 1) % 4;
+    float startAngle = 180 + 90 * startCorner + 45;
+    float endAngle = 180 + 90 * endCorner;
+
+    vector<FloatPoint> polyline;
+    polyline.reserve(18);
+    polyline.push_back(pointOnEllipse(cornerCenters[startCorner], cornerRadii[startCorner], startAngle));
+    appendArcPoints(polyline, cornerCenters[startCorner], cornerRadii[startCorner], startAngle, startAngle + 45);
+    polyline.push_back(pointOnEllipse(cornerCenters[endCorner], cornerRadii[endCorner], endAngle));
+    appendArcPoints(polyline, cornerCenters[endCorner], cornerRadii[endCorner], endAngle, endAngle + 45);
+
+    ObjectPainter::drawDottedPolyline(graphicsContext, polyline.data(), polyline.size(), color, thickness);
+}
+
 void BoxBorderPainter::clipBorderSideForComplexInnerPath(GraphicsContext& graphicsContext,
     BoxSide side) const
 {
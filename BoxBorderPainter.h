@@ -35,6 +35,11 @@ public:
     BoxBorderPainter(const ComputedStyle&, const LayoutRect& outer, const LayoutRect& inner,
         const BorderEdge& uniformEdgeInfo);
 
+    // Like the first constructor with both logical edges included, but takes the
+    // rounded rects from a BorderGeometryBatch instead of computing them.
+    BoxBorderPainter(const ComputedStyle&, BackgroundBleedAvoidance,
+        const FloatRoundedRect& outer, const FloatRoundedRect& inner);
+
     void paintBorder(const PaintInfo&, const LayoutRect& borderRect) const;
 
 private:
@@ -57,6 +62,9 @@ private:
 
     void drawBoxSideFromPath(GraphicsContext&, const LayoutRect&, const Path&, float thickness,
         float drawThickness, BoxSide, Color, EBorderStyle) const;
+    void drawDottedRoundedBoxSide(GraphicsContext&, BoxSide, float thickness, Color) const;
+    bool drawMiteredBoxSide(GraphicsContext&, const FloatRect& sideRect, BoxSide, Color, EBorderStyle,
+        MiterType miter1, int adjacentWidth1, MiterType miter2, int adjacentWidth2) const;
     void clipBorderSidePolygon(GraphicsContext&, BoxSide, MiterType miter1, MiterType miter2) const;
     void clipBorderSideForComplexInnerPath(GraphicsContext&, BoxSide) const;
 
@@ -22,6 +22,11 @@ void Color::getRGBA(float& r, float& g, float& b, float& a) const
 }
 
 
+RGBA32 makeRGB(int r, int g, int b)
+{
+    return 0xFF000000 | clampTo(r, 0, 255) << 16 | clampTo(g, 0, 255) << 8 | clampTo(b, 0, 255);
+}
+
 RGBA32 makeRGBA(int r, int g, int b, int a)
 {
     return clampTo(a, 0, 255) << 24 | clampTo(r, 0, 255) << 16 | clampTo(g, 0, 255) << 8 | clampTo(b, 0, 255);
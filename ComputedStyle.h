@@ -130,6 +130,24 @@ class ComputedStyle {
 
         BorderData  m_border;
 
+        struct OutlineData {
+            OutlineData() : m_width(0), m_offset(0), m_style(BorderStyleNone) { }
+
+            int m_width;
+            int m_offset;
+            EBorderStyle m_style;
+            Color m_color;
+        };
+
+        OutlineData m_outline;
+
+        bool hasOutline() const { return outlineWidth() > 0 && m_outline.m_style > BorderStyleHidden; }
+        int outlineWidth() const { return m_outline.m_style == BorderStyleNone ? 0 : m_outline.m_width; }
+        int outlineOffset() const { return m_outline.m_offset; }
+        EBorderStyle outlineStyle() const { return m_outline.m_style; }
+        bool outlineStyleIsAuto() const { return false; }
+        Color outlineColor() const { return m_outline.m_color; }
+
         static float floatValueForLength(float x, float max) { if (x > max) return max; return x; }
 
         static FloatRoundedRect::Radii calcRadiiFor(const BorderData& border, FloatSize size)
@@ -0,0 +1,288 @@
+#include "CountingCanvas.h"
+
+#include <assert.h>
+#include <string.h>
+
+namespace blink {
+
+static const char* const opNames[CountingCanvas::OpCount] = {
+    "save",
+    "saveLayer",
+    "restore",
+    "clipRect",
+    "clipRRect",
+    "clipPath",
+    "clipRegion",
+    "drawPaint",
+    "drawPoints",
+    "drawRect",
+    "drawRegion",
+    "drawOval",
+    "drawArc",
+    "drawRRect",
+    "drawDRRect",
+    "drawPath",
+    "drawVertices",
+    "drawImage",
+    "drawImageRect",
+    "drawText",
+    "drawPicture",
+};
+
+CountingCanvas::ItemCounts::ItemCounts(const std::string& itemType)
+    : type(itemType)
+    , items(0)
+{
+    memset(counts, 0, sizeof(counts));
+}
+
+CountingCanvas::CountingCanvas(int width, int height)
+    : SkNWayCanvas(width, height)
+{
+    resetCounts();
+}
+
+const char* CountingCanvas::opName(Op op)
+{
+    return opNames[op];
+}
+
+int CountingCanvas::count(Op op) const
+{
+    int total = 0;
+    for (const ItemCounts& item : m_itemCounts)
+        total += item.counts[op];
+    return total;
+}
+
+int CountingCanvas::drawCount() const
+{
+    int total = 0;
+    for (int op = DrawPaint; op < OpCount; ++op)
+        total += count(static_cast<Op>(op));
+    return total;
+}
+
+void CountingCanvas::resetCounts()
+{
+    m_itemCounts.assign(1, ItemCounts("(no item)"));
+    m_itemStack.assign(1, 0);
+}
+
+void CountingCanvas::beginItem(const std::string& type)
+{
+    size_t index = 0;
+    while (index < m_itemCounts.size() && m_itemCounts[index].type != type)
+        ++index;
+
+    if (index == m_itemCounts.size())
+        m_itemCounts.push_back(ItemCounts(type));
+
+    ++m_itemCounts[index].items;
+    m_itemStack.push_back(index);
+}
+
+void CountingCanvas::endItem()
+{
+    assert(m_itemStack.size() > 1);
+    m_itemStack.pop_back();
+}
+
+void CountingCanvas::printTable(FILE* file) const
+{
+    static const Op columns[] = {
+        DrawRect, DrawRRect, DrawDRRect, DrawPath, DrawVertices, DrawPoints, DrawText,
+        SaveLayer, ClipRect, ClipRRect, ClipPath,
+    };
+    static const int numColumns = sizeof(columns) / sizeof(columns[0]);
+
+    fprintf(file, "%-18s %8s", "item", "items");
+    for (int column = 0; column < numColumns; ++column)
+        fprintf(file, " %12s", opName(columns[column]));
+    fprintf(file, " %12s %12s\n", "all draws", "draws/item");
+
+    ItemCounts total("total");
+
+    auto printRow = [&](const ItemCounts& row) {
+        int draws = 0;
+        for (int op = DrawPaint; op < OpCount; ++op)
+            draws += row.counts[op];
+
+        fprintf(file, "%-18s %8d", row.type.c_str(), row.items);
+        for (int column = 0; column < numColumns; ++column)
+            fprintf(file, " %12d", row.counts[columns[column]]);
+        fprintf(file, " %12d %12.2f\n", draws, row.items ? static_cast<double>(draws) / row.items : 0.0);
+    };
+
+    for (const ItemCounts& item : m_itemCounts) {
+        bool empty = !item.items;
+        for (int op = 0; op < OpCount && empty; ++op)
+            empty = !item.counts[op];
+        if (empty)
+            continue;
+
+        printRow(item);
+        total.items += item.items;
+        for (int op = 0; op < OpCount; ++op)
+            total.counts[op] += item.counts[op];
+    }
+    printRow(total);
+}
+
+void CountingCanvas::willSave()
+{
+    record(Save);
+    SkNWayCanvas::willSave();
+}
+
+SkCanvas::SaveLayerStrategy CountingCanvas::getSaveLayerStrategy(const SaveLayerRec& rec)
+{
+    record(SaveLayer);
+    return SkNWayCanvas::getSaveLayerStrategy(rec);
+}
+
+void CountingCanvas::willRestore()
+{
+    record(Restore);
+    SkNWayCanvas::willRestore();
+}
+
+void CountingCanvas::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint)
+{
+    record(DrawDRRect);
+    SkNWayCanvas::onDrawDRRect(outer, inner, paint);
+}
+
+void CountingCanvas::onDrawText(const void* text, size_t byteLength, SkScalar x, SkScalar y, const SkPaint& paint)
+{
+    record(DrawText);
+    SkNWayCanvas::onDrawText(text, byteLength, x, y, paint);
+}
+
+void CountingCanvas::onDrawPosText(const void* text, size_t byteLength, const SkPoint pos[], const SkPaint& paint)
+{
+    record(DrawText);
+    SkNWayCanvas::onDrawPosText(text, byteLength, pos, paint);
+}
+
+void CountingCanvas::onDrawPosTextH(const void* text, size_t byteLength, const SkScalar xpos[], SkScalar constY, const SkPaint& paint)
+{
+    record(DrawText);
+    SkNWayCanvas::onDrawPosTextH(text, byteLength, xpos, constY, paint);
+}
+
+void CountingCanvas::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path, const SkMatrix* matrix, const SkPaint& paint)
+{
+    record(DrawText);
+    SkNWayCanvas::onDrawTextOnPath(text, byteLength, path, matrix, paint);
+}
+
+void CountingCanvas::onDrawTextRSXform(const void* text, size_t byteLength, const SkRSXform xform[], const SkRect* cull, const SkPaint& paint)
+{
+    record(DrawText);
+    SkNWayCanvas::onDrawTextRSXform(text, byteLength, xform, cull, paint);
+}
+
+void CountingCanvas::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y, const SkPaint& paint)
+{
+    record(DrawText);
+    SkNWayCanvas::onDrawTextBlob(blob, x, y, paint);
+}
+
+void CountingCanvas::onDrawPaint(const SkPaint& paint)
+{
+    record(DrawPaint);
+    SkNWayCanvas::onDrawPaint(paint);
+}
+
+void CountingCanvas::onDrawPoints(PointMode mode, size_t count, const SkPoint pts[], const SkPaint& paint)
+{
+    record(DrawPoints);
+    SkNWayCanvas::onDrawPoints(mode, count, pts, paint);
+}
+
+void CountingCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint)
+{
+    record(DrawRect);
+    SkNWayCanvas::onDrawRect(rect, paint);
+}
+
+void CountingCanvas::onDrawRegion(const SkRegion& region, const SkPaint& paint)
+{
+    record(DrawRegion);
+    SkNWayCanvas::onDrawRegion(region, paint);
+}
+
+void CountingCanvas::onDrawOval(const SkRect& rect, const SkPaint& paint)
+{
+    record(DrawOval);
+    SkNWayCanvas::onDrawOval(rect, paint);
+}
+
+void CountingCanvas::onDrawArc(const SkRect& rect, SkScalar startAngle, SkScalar sweepAngle, bool useCenter, const SkPaint& paint)
+{
+    record(DrawArc);
+    SkNWayCanvas::onDrawArc(rect, startAngle, sweepAngle, useCenter, paint);
+}
+
+void CountingCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint)
+{
+    record(DrawRRect);
+    SkNWayCanvas::onDrawRRect(rrect, paint);
+}
+
+void CountingCanvas::onDrawPath(const SkPath& path, const SkPaint& paint)
+{
+    record(DrawPath);
+    SkNWayCanvas::onDrawPath(path, paint);
+}
+
+void CountingCanvas::onDrawImage(const SkImage* image, SkScalar left, SkScalar top, const SkPaint* paint)
+{
+    record(DrawImage);
+    SkNWayCanvas::onDrawImage(image, left, top, paint);
+}
+
+void CountingCanvas::onDrawImageRect(const SkImage* image, const SkRect* src, const SkRect& dst, const SkPaint* paint, SrcRectConstraint constraint)
+{
+    record(DrawImageRect);
+    SkNWayCanvas::onDrawImageRect(image, src, dst, paint, constraint);
+}
+
+void CountingCanvas::onDrawVerticesObject(const SkVertices* vertices, SkBlendMode mode, const SkPaint& paint)
+{
+    record(DrawVertices);
+    SkNWayCanvas::onDrawVerticesObject(vertices, mode, paint);
+}
+
+void CountingCanvas::onDrawPicture(const SkPicture* picture, const SkMatrix* matrix, const SkPaint* paint)
+{
+    record(DrawPicture);
+    SkNWayCanvas::onDrawPicture(picture, matrix, paint);
+}
+
+void CountingCanvas::onClipRect(const SkRect& rect, SkClipOp op, ClipEdgeStyle edgeStyle)
+{
+    record(ClipRect);
+    SkNWayCanvas::onClipRect(rect, op, edgeStyle);
+}
+
+void CountingCanvas::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle edgeStyle)
+{
+    record(ClipRRect);
+    SkNWayCanvas::onClipRRect(rrect, op, edgeStyle);
+}
+
+void CountingCanvas::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle)
+{
+    record(ClipPath);
+    SkNWayCanvas::onClipPath(path, op, edgeStyle);
+}
+
+void CountingCanvas::onClipRegion(const SkRegion& region, SkClipOp op)
+{
+    record(ClipRegion);
+    SkNWayCanvas::onClipRegion(region, op);
+}
+
+} // namespace blink
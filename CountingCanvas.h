@@ -0,0 +1,111 @@
+#ifndef CountingCanvas_h
+#define CountingCanvas_h
+
+#include "../include/utils/SkNWayCanvas.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace blink {
+
+// Counts the calls made on it by kind and forwards them to the canvases added with
+// addCanvas(). With no canvases added it only counts, which is handy for finding out
+// what a painter or picture issues without paying for rasterization.
+//
+// Calls can also be attributed to the display item that issued them by bracketing
+// each item with beginItem() and endItem(). Items may nest; calls made by a nested
+// item only count towards the innermost one.
+class CountingCanvas : public SkNWayCanvas {
+public:
+    enum Op {
+        Save,
+        SaveLayer,
+        Restore,
+        ClipRect,
+        ClipRRect,
+        ClipPath,
+        ClipRegion,
+        // Everything from here on is a draw; drawCount() relies on this order.
+        DrawPaint,
+        DrawPoints,
+        DrawRect,
+        DrawRegion,
+        DrawOval,
+        DrawArc,
+        DrawRRect,
+        DrawDRRect,
+        DrawPath,
+        DrawVertices,
+        DrawImage,
+        DrawImageRect,
+        DrawText,
+        DrawPicture,
+        OpCount
+    };
+
+    CountingCanvas(int width, int height);
+
+    static const char* opName(Op);
+
+    // Totals over all items.
+    int count(Op) const;
+    // Sum of the Draw* counts, leaving out state changes and clips.
+    int drawCount() const;
+    void resetCounts();
+
+    void beginItem(const std::string& type);
+    void endItem();
+
+    // Prints one row per item type with its item count and the calls it issued.
+    void printTable(FILE*) const;
+
+protected:
+    void willSave() override;
+    SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec&) override;
+    void willRestore() override;
+
+    void onDrawDRRect(const SkRRect&, const SkRRect&, const SkPaint&) override;
+    void onDrawText(const void*, size_t, SkScalar, SkScalar, const SkPaint&) override;
+    void onDrawPosText(const void*, size_t, const SkPoint[], const SkPaint&) override;
+    void onDrawPosTextH(const void*, size_t, const SkScalar[], SkScalar, const SkPaint&) override;
+    void onDrawTextOnPath(const void*, size_t, const SkPath&, const SkMatrix*, const SkPaint&) override;
+    void onDrawTextRSXform(const void*, size_t, const SkRSXform[], const SkRect*, const SkPaint&) override;
+    void onDrawTextBlob(const SkTextBlob*, SkScalar, SkScalar, const SkPaint&) override;
+    void onDrawPaint(const SkPaint&) override;
+    void onDrawPoints(PointMode, size_t, const SkPoint[], const SkPaint&) override;
+    void onDrawRect(const SkRect&, const SkPaint&) override;
+    void onDrawRegion(const SkRegion&, const SkPaint&) override;
+    void onDrawOval(const SkRect&, const SkPaint&) override;
+    void onDrawArc(const SkRect&, SkScalar, SkScalar, bool, const SkPaint&) override;
+    void onDrawRRect(const SkRRect&, const SkPaint&) override;
+    void onDrawPath(const SkPath&, const SkPaint&) override;
+    void onDrawImage(const SkImage*, SkScalar, SkScalar, const SkPaint*) override;
+    void onDrawImageRect(const SkImage*, const SkRect*, const SkRect&, const SkPaint*, SrcRectConstraint) override;
+    void onDrawVerticesObject(const SkVertices*, SkBlendMode, const SkPaint&) override;
+    void onDrawPicture(const SkPicture*, const SkMatrix*, const SkPaint*) override;
+
+    void onClipRect(const SkRect&, SkClipOp, ClipEdgeStyle) override;
+    void onClipRRect(const SkRRect&, SkClipOp, ClipEdgeStyle) override;
+    void onClipPath(const SkPath&, SkClipOp, ClipEdgeStyle) override;
+    void onClipRegion(const SkRegion&, SkClipOp) override;
+
+private:
+    struct ItemCounts {
+        explicit ItemCounts(const std::string&);
+
+        std::string type;
+        int items;
+        int counts[OpCount];
+    };
+
+    void record(Op op) { ++m_itemCounts[m_itemStack.back()].counts[op]; }
+
+    // m_itemCounts[0] collects the calls made outside of any item.
+    std::vector<ItemCounts> m_itemCounts;
+    std::vector<size_t> m_itemStack;
+};
+
+} // namespace blink
+
+#endif // CountingCanvas_h
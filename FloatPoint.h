@@ -195,6 +195,11 @@ inline FloatPoint operator+(const FloatPoint& a, const FloatSize& b)
     return FloatPoint(a.x() + b.width(), a.y() + b.height());
 }
 
+inline FloatSize operator-(const FloatPoint& a, const FloatPoint& b)
+{
+    return FloatSize(a.x() - b.x(), a.y() - b.y());
+}
+
 #if 0
 inline FloatPoint operator+(const FloatPoint& a, const IntSize& b)
 {
@@ -215,11 +220,6 @@ inline FloatPoint operator+(const FloatPoint& a, const IntPoint& b)
     return FloatPoint(a.x() + b.x(), a.y() + b.y());
 }
 
-inline FloatSize operator-(const FloatPoint& a, const FloatPoint& b)
-{
-    return FloatSize(a.x() - b.x(), a.y() - b.y());
-}
-
 inline FloatSize operator-(const FloatPoint& a, const IntPoint& b)
 {
     return FloatSize(a.x() - b.x(), a.y() - b.y());
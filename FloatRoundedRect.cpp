@@ -55,6 +55,19 @@ FloatRoundedRect::FloatRoundedRect(const FloatRect& rect, const FloatSize& topLe
 {
 }
 
+FloatRoundedRect::FloatRoundedRect(const SkRRect& rrect)
+    : m_rect(rrect.rect())
+{
+    SkVector radii = rrect.radii(SkRRect::kUpperLeft_Corner);
+    m_radii.setTopLeft(FloatSize(radii.x(), radii.y()));
+    radii = rrect.radii(SkRRect::kUpperRight_Corner);
+    m_radii.setTopRight(FloatSize(radii.x(), radii.y()));
+    radii = rrect.radii(SkRRect::kLowerLeft_Corner);
+    m_radii.setBottomLeft(FloatSize(radii.x(), radii.y()));
+    radii = rrect.radii(SkRRect::kLowerRight_Corner);
+    m_radii.setBottomRight(FloatSize(radii.x(), radii.y()));
+}
+
 bool FloatRoundedRect::Radii::isZero() const
 {
     return m_topLeft.isZero() && m_topRight.isZero() && m_bottomLeft.isZero() && m_bottomRight.isZero();
@@ -311,6 +324,29 @@ void FloatRoundedRect::constrainRadii()
     m_radii.scaleAndFloor(calcBorderRadiiConstraintScaleFor(rect(), getRadii()));
 }
 
+static inline float quarterEllipseLength(const FloatSize& radii)
+{
+    float a = radii.width();
+    float b = radii.height();
+    if (!a || !b)
+        return 0;
+    return static_cast<float>(M_PI / 4) * (3 * (a + b) - sqrtf((3 * a + b) * (a + 3 * b)));
+}
+
+float FloatRoundedRect::perimeter() const
+{
+    float straightLength = std::max(0.f, m_rect.width() - m_radii.topLeft().width() - m_radii.topRight().width())
+        + std::max(0.f, m_rect.width() - m_radii.bottomLeft().width() - m_radii.bottomRight().width())
+        + std::max(0.f, m_rect.height() - m_radii.topLeft().height() - m_radii.bottomLeft().height())
+        + std::max(0.f, m_rect.height() - m_radii.topRight().height() - m_radii.bottomRight().height());
+
+    return straightLength
+        + quarterEllipseLength(m_radii.topLeft())
+        + quarterEllipseLength(m_radii.topRight())
+        + quarterEllipseLength(m_radii.bottomLeft())
+        + quarterEllipseLength(m_radii.bottomRight());
+}
+
 void FloatRoundedRect::includeLogicalEdges(const Radii& edges, bool isHorizontal, bool includeLogicalLeftEdge, bool includeLogicalRightEdge)
 {
     m_radii.includeLogicalEdges(edges, isHorizontal, includeLogicalLeftEdge, includeLogicalRightEdge);
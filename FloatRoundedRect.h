@@ -102,6 +102,7 @@ public:
     explicit FloatRoundedRect(const FloatRect&, const Radii& = Radii());
     FloatRoundedRect(float x, float y, float width, float height);
     FloatRoundedRect(const FloatRect&, const FloatSize& topLeft, const FloatSize& topRight, const FloatSize& bottomLeft, const FloatSize& bottomRight);
+    explicit FloatRoundedRect(const SkRRect&);
 
     const FloatRect& rect() const { return m_rect; }
     const Radii& getRadii() const { return m_radii; }
@@ -124,6 +125,10 @@ public:
     // Returns a quickly computed rect enclosed by the rounded rect.
     FloatRect radiusCenterRect() const;
 
+    // Returns the length of the outline, using Ramanujan's ellipse perimeter approximation
+    // for the corners. Assumes the radii are constrained to the rect.
+    float perimeter() const;
+
     FloatRect topLeftCorner() const
     {
         return FloatRect(m_rect.x(), m_rect.y(), m_radii.topLeft().width(), m_radii.topLeft().height());
@@ -2,9 +2,12 @@
 #include "FloatRect.h"
 #include "FloatRoundedRect.h"
 #include "IntPoint.h"
+#include "PaintStats.h"
 #include "../include/core/SkPath.h"
 #include "../include/core/SkPaint.h"
 #include "../include/core/SkCanvas.h"
+#include "../include/core/SkVertices.h"
+#include <memory>
 #include <vector>
 namespace blink
 {
@@ -30,73 +33,177 @@ enum WindRule {
 typedef float DashArrayElement;
 typedef std::vector<DashArrayElement> DashArray;
 
+// Paint state that save()/restore() track alongside the canvas. The fill and stroke
+// SkPaints are kept up to date by the setters so draw calls can use them as is.
+struct GraphicsContextState
+{
+        GraphicsContextState()
+            : m_strokeStyle(SolidStroke)
+            , m_strokeThickness(0)
+            , m_shouldAntialias(true)
+            , m_saveCount(0)
+        {
+            m_strokePaint.setStyle(SkPaint::kStroke_Style);
+            m_strokePaint.setStrokeWidth(0);
+            m_strokePaint.setColor(m_strokeColor.rgb());
+            m_strokePaint.setAntiAlias(true);
+            m_fillPaint.setColor(m_fillColor.rgb());
+            m_fillPaint.setAntiAlias(true);
+        }
+
+        const SkPaint& strokePaint() const { return m_strokePaint; }
+        const SkPaint& fillPaint() const { return m_fillPaint; }
+
+        StrokeStyle getStrokeStyle() const { return m_strokeStyle; }
+        void setStrokeStyle(StrokeStyle style) { m_strokeStyle = style; }
+
+        float getStrokeThickness() const { return m_strokeThickness; }
+        void setStrokeThickness(float thickness)
+        {
+            m_strokeThickness = thickness;
+            m_strokePaint.setStrokeWidth(thickness);
+        }
+
+        Color getStrokeColor() const { return m_strokeColor; }
+        void setStrokeColor(const Color& color)
+        {
+            m_strokeColor = color;
+            m_strokePaint.setColor(color.rgb());
+        }
+
+        Color getFillColor() const { return m_fillColor; }
+        void setFillColor(const Color& color)
+        {
+            m_fillColor = color;
+            m_fillPaint.setColor(color.rgb());
+        }
+
+        bool shouldAntialias() const { return m_shouldAntialias; }
+        void setShouldAntialias(bool shouldAntialias)
+        {
+            m_shouldAntialias = shouldAntialias;
+            m_strokePaint.setAntiAlias(shouldAntialias);
+            m_fillPaint.setAntiAlias(shouldAntialias);
+        }
+
+        // Number of save() calls this state stands for that have not been realized with a
+        // copy yet, see GraphicsContext::realizePaintSave().
+        unsigned saveCount() const { return m_saveCount; }
+        void incrementSaveCount() { ++m_saveCount; }
+        void decrementSaveCount() { --m_saveCount; }
+        void resetSaveCount() { m_saveCount = 0; }
+
+private:
+        SkPaint m_strokePaint;
+        SkPaint m_fillPaint;
+        StrokeStyle m_strokeStyle;
+        float m_strokeThickness;
+        Color m_strokeColor;
+        Color m_fillColor;
+        bool m_shouldAntialias;
+        unsigned m_saveCount;
+};
+
 struct GraphicsContext
 {
-        GraphicsContext(SkCanvas *c) : m_canvas(c) {}
+        GraphicsContext(SkCanvas *c)
+            : m_canvas(c)
+            , m_paintStateIndex(0)
+            , m_quadFastPathsEnabled(true)
+            , m_batchingQuads(false)
+            , m_canBatchAlignedRects(false)
+            , m_quadBatchCount(0)
+        {
+            m_paintStateStack.push_back(std::unique_ptr<GraphicsContextState>(new GraphicsContextState));
+            m_paintState = m_paintStateStack.back().get();
+        }
+        ~GraphicsContext() { flushQuadBatch(); }
         SkCanvas* m_canvas;
-        bool mShouldAntialias = true;
-        bool shouldAntialias() { return mShouldAntialias; }
-        void setShouldAntialias(bool x) { mShouldAntialias = x; }
 
-        StrokeStyle mStrokeStyle;
-        void setStrokeStyle(StrokeStyle s) { mStrokeStyle = s; }
-        StrokeStyle getStrokeStyle() { return mStrokeStyle; }
+        bool shouldAntialias() const { return immutableState()->shouldAntialias(); }
+        void setShouldAntialias(bool x)
+        {
+            if (immutableState()->shouldAntialias() != x)
+                mutableState()->setShouldAntialias(x);
+        }
 
-        Color mStrokeColor;
-        void setStrokeColor(Color c) { mStrokeColor = c; }
+        void setStrokeStyle(StrokeStyle s)
+        {
+            if (immutableState()->getStrokeStyle() != s)
+                mutableState()->setStrokeStyle(s);
+        }
+        StrokeStyle getStrokeStyle() const { return immutableState()->getStrokeStyle(); }
 
-        Color mFillColor;
-        void setFillColor(Color c) { mFillColor = c; }
+        void setStrokeColor(Color c)
+        {
+            if (immutableState()->getStrokeColor() != c)
+                mutableState()->setStrokeColor(c);
+        }
+
+        void setFillColor(Color c)
+        {
+            if (immutableState()->getFillColor() != c)
+                mutableState()->setFillColor(c);
+        }
+
+        void setStrokeThickness(float thickness)
+        {
+            if (immutableState()->getStrokeThickness() != thickness)
+                mutableState()->setStrokeThickness(thickness);
+        }
+        float strokeThickness() const { return immutableState()->getStrokeThickness(); }
+
+        const SkPaint& fillPaint() const { return immutableState()->fillPaint(); }
+        const SkPaint& strokePaint() const { return immutableState()->strokePaint(); }
 
         void strokeRect(FloatRect r, float borderWidth) {
-            SkPaint paint;
-            paint.setColor(mStrokeColor.rgb());
-            paint.setStyle(SkPaint::kStroke_Style);
+            flushQuadBatch();
+            if (borderWidth == strokeThickness()) {
+                m_canvas->drawRect(r, strokePaint());
+                return;
+            }
+            SkPaint paint(strokePaint());
             paint.setStrokeWidth(borderWidth);
             m_canvas->drawRect(r, paint);
         }
 
-        void drawPath(SkPath &path, SkPaint &paint) {
+        void drawPath(const SkPath &path, const SkPaint &paint) {
+            flushQuadBatch();
             m_canvas->drawPath(path, paint);
         }
 
         void drawRect(const SkRect &rect) {
-            SkPaint paint;
-            paint.setColor(mFillColor.rgb());
-            m_canvas->drawRect(rect, paint);
+            flushQuadBatch();
+            m_canvas->drawRect(rect, fillPaint());
         }
 
         void fillRect(const SkRect &rect, Color color) {
-            SkPaint paint;
+            flushQuadBatch();
+            if (color == immutableState()->getFillColor()) {
+                m_canvas->drawRect(rect, fillPaint());
+                return;
+            }
+            SkPaint paint(fillPaint());
             paint.setColor(color.rgb());
             m_canvas->drawRect(rect, paint);
         }
 
 
         void drawLine(IntPoint start, IntPoint end) {
-            SkPaint paint;
-            paint.setColor(mStrokeColor.rgb());
-            paint.setStyle(SkPaint::kStroke_Style);
-            paint.setStrokeWidth(m_strokeThickness);
-            m_canvas->drawLine(start.x(), start.y(), end.x(), end.y(), paint);
+            flushQuadBatch();
+            m_canvas->drawLine(start.x(), start.y(), end.x(), end.y(), strokePaint());
         }
 
         void clip(const FloatRect& rect) { clipRect(rect); }
 
-        SkPaint fillPaint() {
-            SkPaint paint;
-            paint.setColor(mFillColor.rgb());
-            return paint;
-        }
-
-        void fillPath(SkPath &path) {
-            SkPaint paint;
-            paint.setColor(mFillColor.rgb());
-            m_canvas->drawPath(path, paint);
+        void fillPath(const SkPath &path) {
+            flushQuadBatch();
+            m_canvas->drawPath(path, fillPaint());
         }
 
         void clipRect(const SkRect& rect, SkClipOp op = SkClipOp::kIntersect)
         {
+            flushQuadBatch();
             m_canvas->clipRect(rect, op, true);
         }
 
@@ -116,25 +223,56 @@ struct GraphicsContext
 
         void clipRRect(const SkRRect& rect, SkClipOp op = SkClipOp::kIntersect)
         {
+            flushQuadBatch();
             m_canvas->clipRRect(rect, op, true);
         }
 
         void clipPath(const SkPath& path, AntiAliasingMode aa)
         {
+            flushQuadBatch();
             m_canvas->clipPath(path, SkClipOp::kIntersect, aa == AntiAliased);
         }
         void fillDRRect(const FloatRoundedRect& outer,
                             const FloatRoundedRect& inner, const Color& color)
         {
-            SkPaint paint;
+            flushQuadBatch();
+            if (color == immutableState()->getFillColor()) {
+                m_canvas->drawDRRect(outer, inner, fillPaint());
+                return;
+            }
+            SkPaint paint(fillPaint());
             paint.setColor(color.rgb());
             m_canvas->drawDRRect(outer, inner, paint);
         }
 
-        void save() { m_canvas->save(); }
-        void restore() { m_canvas->restore(); }
+        // The paint state is only copied once something changes after a save(), so
+        // save/restore pairs around code that leaves the state alone stay cheap.
+        void save()
+        {
+            flushQuadBatch();
+            m_paintState->incrementSaveCount();
+            m_canvas->save();
+        }
+        void restore()
+        {
+            flushQuadBatch();
+            // Ignore an unbalanced restore().
+            if (!m_paintStateIndex && !m_paintState->saveCount())
+                return;
+
+            if (m_paintState->saveCount()) {
+                m_paintState->decrementSaveCount();
+            } else {
+                m_paintStateIndex--;
+                m_paintState = m_paintStateStack[m_paintStateIndex].get();
+            }
+
+            m_canvas->restore();
+        }
 
         void beginLayer(float opacity) {
+            flushQuadBatch();
+            PaintStats::countLayer();
             SkPaint layerPaint;
             layerPaint.setAlpha(static_cast<unsigned char>(opacity * 255));
             //layerPaint.setXfermodeMode(xfermode);
@@ -144,6 +282,7 @@ struct GraphicsContext
             m_canvas->saveLayer(nullptr, &layerPaint);
         }
         void endLayer() {
+            flushQuadBatch();
             m_canvas->restore();
         }
 
@@ -151,17 +290,242 @@ struct GraphicsContext
         {
         }
 
-        float m_strokeThickness;
-        void setStrokeThickness(float thickness) {
-            m_strokeThickness = thickness;
-        }
         void strokePath(const SkPath &path) {
-            SkPaint paint;
-            paint.setColor(mStrokeColor.rgb());
-            paint.setStyle(SkPaint::kStroke_Style);
-            paint.setStrokeWidth(m_strokeThickness);
-            m_canvas->drawPath(path, paint);
+            flushQuadBatch();
+            m_canvas->drawPath(path, strokePaint());
         }
+
+        // Draws one round dot of the given diameter centered on each point, in a single call.
+        void drawDots(const SkPoint points[], size_t count, float diameter) {
+            flushQuadBatch();
+            SkPaint paint(strokePaint());
+            paint.setStrokeWidth(diameter);
+            paint.setStrokeCap(SkPaint::kRound_Cap);
+            m_canvas->drawPoints(SkCanvas::kPoints_PointMode, count, points, paint);
+        }
+
+        // Fills the quad with |color|. Between beginQuadBatch() and endQuadBatch(), quads that
+        // drawVertices() rasterizes the same way (convex ones drawn without anti-aliasing, and
+        // pixel aligned rects) are collected per color and drawn with one drawVertices() per color.
+        // Any other drawing, clip or save/restore flushes the collected quads first, so they keep
+        // their paint order relative to everything else.
+        void fillQuad(const SkPoint quad[4], const Color& color, bool antialias)
+        {
+            if (m_batchingQuads && ((!antialias && isConvexQuad(quad)) || (m_canBatchAlignedRects && isPixelAlignedRect(quad)))) {
+                appendQuadToBatch(quad, color);
+                return;
+            }
+
+            flushQuadBatch();
+            SkPaint paint(fillPaint());
+            paint.setAntiAlias(antialias);
+            paint.setColor(color.rgb());
+
+            QuadShape shape = m_quadFastPathsEnabled ? classifyQuad(quad) : GeneralQuad;
+            if (shape == RectQuad) {
+                m_canvas->drawRect(quadBounds(quad), paint);
+                return;
+            }
+
+            // Reuse one path so that its point storage is only allocated once. Trapezoids
+            // are known to be convex, which spares Skia from working that out.
+            m_quadPath.rewind();
+            m_quadPath.moveTo(quad[0]);
+            m_quadPath.lineTo(quad[1]);
+            m_quadPath.lineTo(quad[2]);
+            m_quadPath.lineTo(quad[3]);
+            m_quadPath.close();
+            if (shape == TrapezoidQuad)
+                m_quadPath.setConvexity(SkPath::kConvex_Convexity);
+            m_canvas->drawPath(m_quadPath, paint);
+        }
+
+        bool isBatchingQuads() const { return m_batchingQuads; }
+
+        // With the fast paths off, fillQuad() draws every quad as a plain path right away,
+        // ignoring quad batches and the rect and trapezoid shortcuts. border_fuzz uses this
+        // as the reference to check those paths against.
+        void setQuadFastPathsEnabled(bool enabled)
+        {
+            flushQuadBatch();
+            m_quadFastPathsEnabled = enabled;
+            m_batchingQuads = m_batchingQuads && enabled;
+        }
+
+        void beginQuadBatch()
+        {
+            flushQuadBatch();
+            m_batchingQuads = m_quadFastPathsEnabled;
+
+            // Anti-aliasing a rect only makes no difference when its edges land on pixel
+            // boundaries, which needs a device transform that is an integer translation.
+            const SkMatrix& matrix = m_canvas->getTotalMatrix();
+            m_canBatchAlignedRects = !(matrix.getType() & ~SkMatrix::kTranslate_Mask)
+                && matrix.getTranslateX() == floorf(matrix.getTranslateX())
+                && matrix.getTranslateY() == floorf(matrix.getTranslateY());
+        }
+
+        void endQuadBatch()
+        {
+            flushQuadBatch();
+            m_batchingQuads = false;
+        }
+
+private:
+        const GraphicsContextState* immutableState() const { return m_paintState; }
+
+        struct QuadBatch {
+            Color color;
+            SkRect bounds;
+            std::vector<SkPoint> triangles;
+        };
+
+        enum QuadShape { RectQuad, TrapezoidQuad, GeneralQuad };
+
+        // Box sides are rects when neither adjacent side is mitered and trapezoids
+        // otherwise, with the two parallel edges running along an axis.
+        static QuadShape classifyQuad(const SkPoint q[4])
+        {
+            if ((q[0].x() == q[1].x() && q[1].y() == q[2].y() && q[2].x() == q[3].x() && q[3].y() == q[0].y())
+                || (q[0].y() == q[1].y() && q[1].x() == q[2].x() && q[2].y() == q[3].y() && q[3].x() == q[0].x()))
+                return RectQuad;
+
+            // The parallel edges must run in opposite directions, or the quad crosses itself.
+            if (q[0].y() == q[1].y() && q[2].y() == q[3].y() && (q[1].x() - q[0].x()) * (q[3].x() - q[2].x()) <= 0)
+                return TrapezoidQuad;
+            if (q[1].y() == q[2].y() && q[3].y() == q[0].y() && (q[2].x() - q[1].x()) * (q[0].x() - q[3].x()) <= 0)
+                return TrapezoidQuad;
+            if (q[0].x() == q[1].x() && q[2].x() == q[3].x() && (q[1].y() - q[0].y()) * (q[3].y() - q[2].y()) <= 0)
+                return TrapezoidQuad;
+            if (q[1].x() == q[2].x() && q[3].x() == q[0].x() && (q[2].y() - q[1].y()) * (q[0].y() - q[3].y()) <= 0)
+                return TrapezoidQuad;
+            return GeneralQuad;
+        }
+
+        static SkRect quadBounds(const SkPoint quad[4])
+        {
+            SkRect bounds = SkRect::MakeLTRB(quad[0].x(), quad[0].y(), quad[0].x(), quad[0].y());
+            for (int i = 1; i < 4; ++i) {
+                bounds.fLeft = std::min(bounds.fLeft, quad[i].x());
+                bounds.fTop = std::min(bounds.fTop, quad[i].y());
+                bounds.fRight = std::max(bounds.fRight, quad[i].x());
+                bounds.fBottom = std::max(bounds.fBottom, quad[i].y());
+            }
+            return bounds;
+        }
+
+        // The two triangles a batch splits a quad into only cover the quad when it is convex.
+        // Box sides whose adjacent widths overlap along a short side cross themselves.
+        static bool isConvexQuad(const SkPoint q[4])
+        {
+            bool turnsLeft = false;
+            bool turnsRight = false;
+            for (int i = 0; i < 4; ++i) {
+                const SkPoint& a = q[i];
+                const SkPoint& b = q[(i + 1) % 4];
+                const SkPoint& c = q[(i + 2) % 4];
+                float turn = (b.x() - a.x()) * (c.y() - b.y()) - (b.y() - a.y()) * (c.x() - b.x());
+                turnsLeft = turnsLeft || turn < 0;
+                turnsRight = turnsRight || turn > 0;
+            }
+            return !(turnsLeft && turnsRight);
+        }
+
+        static bool isPixelAlignedRect(const SkPoint quad[4])
+        {
+            for (int i = 0; i < 4; ++i) {
+                if (quad[i].x() != floorf(quad[i].x()) || quad[i].y() != floorf(quad[i].y()))
+                    return false;
+            }
+            return classifyQuad(quad) == RectQuad;
+        }
+
+        void appendQuadToBatch(const SkPoint quad[4], const Color& color)
+        {
+            SkRect bounds = quadBounds(quad);
+
+            // Quads of different colors may only share a batch if they can't overlap, since
+            // the batches are drawn one color at a time.
+            QuadBatch* batch = nullptr;
+            for (size_t i = 0; i < m_quadBatchCount; ++i) {
+                QuadBatch& candidate = m_quadBatches[i];
+                if (candidate.color == color) {
+                    batch = &candidate;
+                } else if (bounds.fLeft < candidate.bounds.fRight && candidate.bounds.fLeft < bounds.fRight
+                    && bounds.fTop < candidate.bounds.fBottom && candidate.bounds.fTop < bounds.fBottom) {
+                    flushQuadBatch();
+                    batch = nullptr;
+                    break;
+                }
+            }
+
+            if (!batch) {
+                if (m_quadBatchCount == m_quadBatches.size())
+                    m_quadBatches.push_back(QuadBatch());
+                batch = &m_quadBatches[m_quadBatchCount++];
+                batch->color = color;
+                batch->bounds = bounds;
+                batch->triangles.clear();
+            } else {
+                batch->bounds.fLeft = std::min(batch->bounds.fLeft, bounds.fLeft);
+                batch->bounds.fTop = std::min(batch->bounds.fTop, bounds.fTop);
+                batch->bounds.fRight = std::max(batch->bounds.fRight, bounds.fRight);
+                batch->bounds.fBottom = std::max(batch->bounds.fBottom, bounds.fBottom);
+            }
+
+            const SkPoint triangles[] = { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] };
+            batch->triangles.insert(batch->triangles.end(), triangles, triangles + 6);
+        }
+
+        void flushQuadBatch()
+        {
+            if (!m_quadBatchCount)
+                return;
+
+            SkPaint paint(fillPaint());
+            for (size_t i = 0; i < m_quadBatchCount; ++i) {
+                const QuadBatch& batch = m_quadBatches[i];
+                sk_sp<SkVertices> vertices = SkVertices::MakeCopy(SkVertices::kTriangles_VertexMode,
+                    static_cast<int>(batch.triangles.size()), batch.triangles.data(), nullptr, nullptr);
+                paint.setColor(batch.color.rgb());
+                m_canvas->drawVertices(vertices, SkBlendMode::kModulate, paint);
+            }
+            m_quadBatchCount = 0;
+        }
+
+        GraphicsContextState* mutableState()
+        {
+            realizePaintSave();
+            return m_paintState;
+        }
+
+        // Gives the current save level its own copy of the paint state before it is modified.
+        void realizePaintSave()
+        {
+            if (!m_paintState->saveCount())
+                return;
+
+            m_paintState->decrementSaveCount();
+            ++m_paintStateIndex;
+            if (m_paintStateStack.size() == m_paintStateIndex) {
+                m_paintStateStack.push_back(std::unique_ptr<GraphicsContextState>(new GraphicsContextState(*m_paintState)));
+            } else {
+                *m_paintStateStack[m_paintStateIndex] = *m_paintState;
+            }
+            m_paintState = m_paintStateStack[m_paintStateIndex].get();
+            m_paintState->resetSaveCount();
+        }
+
+        std::vector<std::unique_ptr<GraphicsContextState>> m_paintStateStack;
+        size_t m_paintStateIndex;
+        GraphicsContextState* m_paintState;
+
+        bool m_quadFastPathsEnabled;
+        bool m_batchingQuads;
+        bool m_canBatchAlignedRects;
+        std::vector<QuadBatch> m_quadBatches;
+        size_t m_quadBatchCount;
+        SkPath m_quadPath;
 };
 
 struct GraphicsContextStateSaver
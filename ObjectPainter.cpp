@@ -5,9 +5,15 @@
 #include "ComputedStyleConstants.h"
 #include "ObjectPainter.h"
 #include "GraphicsContext.h"
+#include "BoxBorderPainter.h"
+#include "ComputedStyle.h"
 #include <assert.h>
 #include "IntRect.h"
+#include <algorithm>
+#include <math.h>
+#include <vector>
 #define ASSERT(X) assert(X)
+#define ASSERT_NOT_REACHED() assert(false)
 #if 0
 #include "core/paint/ObjectPainter.h"
 
@@ -23,7 +29,6 @@
 #include "platform/geometry/LayoutPoint.h"
 #endif
 namespace blink {
-#if 0
 namespace {
 void paintSingleRectangleOutline(const PaintInfo& paintInfo, const IntRect& rect, const ComputedStyle& style, const Color& color)
 {
@@ -105,38 +110,231 @@ int adjustJoint(int outlineWidth, OutlineEdgeInfo& edge1, OutlineEdgeInfo& edge2
     }
 }
 
-void paintComplexOutline(GraphicsContext& graphicsContext, const Vector<IntRect> rects, const ComputedStyle& style, const Color& color)
+typedef std::pair<int, int> Span;
+
+// Appends the parts of the sorted, disjoint |spans| not covered by |others| to |result|.
+void subtractSpans(const std::vector<Span>& spans, const std::vector<Span>& others, std::vector<Span>& result)
 {
-    ASSERT(!style.outlineStyleIsAuto());
+    size_t j = 0;
+    for (const Span& span : spans) {
+        int start = span.first;
+        while (j < others.size() && others[j].second <= start)
+            ++j;
+        for (size_t k = j; k < others.size() && others[k].first < span.second; ++k) {
+            if (others[k].first > start)
+                result.push_back(Span(start, others[k].first));
+            start = std::max(start, others[k].second);
+        }
+        if (start < span.second)
+            result.push_back(Span(start, span.second));
+    }
+}
 
-    // Construct a clockwise path along the outer edge of the outline.
-    SkRegion region;
-    int width = style.outlineWidth();
-    int outset = style.outlineOffset() + style.outlineWidth();
-    for (auto& r : rects) {
-        IntRect rect = r;
-        rect.inflate(outset);
-        region.op(rect, SkRegion::kUnion_Op);
+struct BoundaryEdge {
+    IntPoint start;
+    IntPoint end;
+};
+
+bool edgeStartsBefore(const BoundaryEdge& a, const BoundaryEdge& b)
+{
+    return a.start.x() < b.start.x() || (a.start.x() == b.start.x() && a.start.y() < b.start.y());
+}
+
+// Computes the outline of the union of |rects| as closed contours of corner points. Contours run
+// clockwise around the covered area (it is on the right of each edge, with y pointing down), so
+// holes come out counterclockwise. This replaces building an SkRegion with one union op per rect:
+// a single sweep over the horizontal slabs between rect edges finds the covered spans of each slab,
+// whose ends are the vertical edges and whose differences to the slab above are the horizontal ones.
+void computeUnionBoundary(const std::vector<IntRect>& rects, std::vector<std::vector<IntPoint>>& contours)
+{
+    std::vector<IntRect> sortedRects;
+    std::vector<int> ys;
+    for (const IntRect& rect : rects) {
+        if (rect.isEmpty())
+            continue;
+        sortedRects.push_back(rect);
+        ys.push_back(rect.y());
+        ys.push_back(rect.maxY());
     }
-    SkPath path;
-    if (!region.getBoundaryPath(&path))
+    if (sortedRects.empty())
         return;
 
-    Vector<OutlineEdgeInfo, 4> edges;
+    std::sort(sortedRects.begin(), sortedRects.end(),
+        [] (const IntRect& a, const IntRect& b) { return a.y() < b.y(); });
+    std::sort(ys.begin(), ys.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    std::vector<BoundaryEdge> edges;
+    std::vector<const IntRect*> active;
+    std::vector<Span> previous, current, difference;
+    size_t nextRect = 0;
+    for (size_t k = 0; k < ys.size(); ++k) {
+        int top = ys[k];
+
+        // Update the rects overlapping the slab [top, bottom) and collect their merged spans.
+        active.erase(std::remove_if(active.begin(), active.end(),
+            [top] (const IntRect* rect) { return rect->maxY() <= top; }), active.end());
+        while (nextRect < sortedRects.size() && sortedRects[nextRect].y() == top)
+            active.push_back(&sortedRects[nextRect++]);
+
+        current.clear();
+        for (const IntRect* rect : active)
+            current.push_back(Span(rect->x(), rect->maxX()));
+        std::sort(current.begin(), current.end());
+        size_t merged = 0;
+        for (size_t i = 1; i < current.size(); ++i) {
+            if (current[i].first <= current[merged].second)
+                current[merged].second = std::max(current[merged].second, current[i].second);
+            else
+                current[++merged] = current[i];
+        }
+        if (!current.empty())
+            current.resize(merged + 1);
+
+        // Top edges run left to right where the slab starts being covered, bottom edges right to left
+        // where the previous slab stops being covered.
+        difference.clear();
+        subtractSpans(current, previous, difference);
+        for (const Span& span : difference)
+            edges.push_back({ IntPoint(span.first, top), IntPoint(span.second, top) });
+        difference.clear();
+        subtractSpans(previous, current, difference);
+        for (const Span& span : difference)
+            edges.push_back({ IntPoint(span.second, top), IntPoint(span.first, top) });
+
+        if (k + 1 < ys.size()) {
+            int bottom = ys[k + 1];
+            for (const Span& span : current) {
+                edges.push_back({ IntPoint(span.first, bottom), IntPoint(span.first, top) });
+                edges.push_back({ IntPoint(span.second, top), IntPoint(span.second, bottom) });
+            }
+        }
+        previous.swap(current);
+    }
 
-    SkPath::Iter iter(path, false);
-    SkPoint points[4];
-    size_t count = 0;
-    for (SkPath::Verb verb = iter.next(points, false); verb != SkPath::kDone_Verb; verb = iter.next(points, false)) {
-        if (verb != SkPath::kLine_Verb)
+    // Chain the edges into contours. Where two contours touch at a corner a point has two outgoing
+    // edges; taking the right turn keeps each contour around its own covered area.
+    std::sort(edges.begin(), edges.end(), edgeStartsBefore);
+    std::vector<bool> used(edges.size(), false);
+    for (size_t first = 0; first < edges.size(); ++first) {
+        if (used[first])
             continue;
 
-        edges.grow(++count);
-        OutlineEdgeInfo& edge = edges.last();
-        edge.x1 = SkScalarTruncToInt(points[0].x());
-        edge.y1 = SkScalarTruncToInt(points[0].y());
-        edge.x2 = SkScalarTruncToInt(points[1].x());
-        edge.y2 = SkScalarTruncToInt(points[1].y());
+        std::vector<IntPoint> contour;
+        size_t edge = first;
+        while (!used[edge]) {
+            used[edge] = true;
+            contour.push_back(edges[edge].start);
+
+            BoundaryEdge key = { edges[edge].end, edges[edge].end };
+            auto candidate = std::lower_bound(edges.begin(), edges.end(), key, edgeStartsBefore);
+            size_t next = edges.size();
+            for (; candidate != edges.end() && candidate->start == key.start; ++candidate) {
+                size_t index = candidate - edges.begin();
+                if (used[index] && index != first)
+                    continue;
+                int dx = edges[edge].end.x() - edges[edge].start.x();
+                int dy = edges[edge].end.y() - edges[edge].start.y();
+                int nextDx = candidate->end.x() - candidate->start.x();
+                int nextDy = candidate->end.y() - candidate->start.y();
+                next = index;
+                // Right turn: the cross product of the two directions is positive with y down.
+                if (dx * nextDy - dy * nextDx > 0)
+                    break;
+            }
+            if (next == edges.size())
+                break;
+            edge = next;
+        }
+
+        // Drop the points between collinear edges, such as the vertical edges of adjacent slabs.
+        std::vector<IntPoint> corners;
+        size_t count = contour.size();
+        for (size_t i = 0; i < count; ++i) {
+            const IntPoint& prev = contour[(i + count - 1) % count];
+            const IntPoint& point = contour[i];
+            const IntPoint& next = contour[(i + 1) % count];
+            bool collinear = (prev.x() == point.x() && point.x() == next.x())
+                || (prev.y() == point.y() && point.y() == next.y());
+            if (!collinear)
+                corners.push_back(point);
+        }
+        if (corners.size() >= 4)
+            contours.push_back(corners);
+    }
+}
+
+// Computes the polygon covering a solid box side, with the corners mitered by the adjacent widths.
+void solidBoxSideQuad(int x1, int y1, int x2, int y2, BoxSide side, int adjacentWidth1, int adjacentWidth2,
+    FloatPoint quad[4])
+{
+    switch (side) {
+    case BSTop:
+        quad[0] = FloatPoint(x1 + std::max(-adjacentWidth1, 0), y1);
+        quad[1] = FloatPoint(x1 + std::max(adjacentWidth1, 0), y2);
+        quad[2] = FloatPoint(x2 - std::max(adjacentWidth2, 0), y2);
+        quad[3] = FloatPoint(x2 - std::max(-adjacentWidth2, 0), y1);
+        break;
+    case BSBottom:
+        quad[0] = FloatPoint(x1 + std::max(adjacentWidth1, 0), y1);
+        quad[1] = FloatPoint(x1 + std::max(-adjacentWidth1, 0), y2);
+        quad[2] = FloatPoint(x2 - std::max(-adjacentWidth2, 0), y2);
+        quad[3] = FloatPoint(x2 - std::max(adjacentWidth2, 0), y1);
+        break;
+    case BSLeft:
+        quad[0] = FloatPoint(x1, y1 + std::max(-adjacentWidth1, 0));
+        quad[1] = FloatPoint(x1, y2 - std::max(-adjacentWidth2, 0));
+        quad[2] = FloatPoint(x2, y2 - std::max(adjacentWidth2, 0));
+        quad[3] = FloatPoint(x2, y1 + std::max(adjacentWidth1, 0));
+        break;
+    case BSRight:
+        quad[0] = FloatPoint(x1, y1 + std::max(adjacentWidth1, 0));
+        quad[1] = FloatPoint(x1, y2 - std::max(adjacentWidth2, 0));
+        quad[2] = FloatPoint(x2, y2 - std::max(-adjacentWidth2, 0));
+        quad[3] = FloatPoint(x2, y1 + std::max(-adjacentWidth1, 0));
+        break;
+    }
+}
+
+// Appends |quad| to |path| as a closed contour, always with the same winding so that
+// overlapping quads don't cancel each other out under the nonzero fill rule.
+void addQuadToPath(SkPath& path, const FloatPoint quad[4])
+{
+    float area = 0;
+    for (int i = 0; i < 4; ++i) {
+        const FloatPoint& p0 = quad[i];
+        const FloatPoint& p1 = quad[(i + 1) % 4];
+        area += p0.x() * p1.y() - p1.x() * p0.y();
+    }
+    path.moveTo(quad[0]);
+    if (area >= 0) {
+        path.lineTo(quad[1]);
+        path.lineTo(quad[2]);
+        path.lineTo(quad[3]);
+    } else {
+        path.lineTo(quad[3]);
+        path.lineTo(quad[2]);
+        path.lineTo(quad[1]);
+    }
+    path.close();
+}
+
+// Appends the edges to draw along a clockwise |contour| of the outer edge of an outline, each
+// widened inwards by |width| and lengthened over its counterclockwise joints. The adjacent
+// width of the joint after each edge is appended to |jointWidths|.
+void appendOutlineEdges(const std::vector<IntPoint>& contour, int width, std::vector<OutlineEdgeInfo>& edges,
+    std::vector<int>& jointWidths)
+{
+    size_t count = contour.size();
+    ASSERT(count >= 4);
+    size_t first = edges.size();
+    edges.resize(first + count);
+    for (size_t i = 0; i < count; ++i) {
+        OutlineEdgeInfo& edge = edges[first + i];
+        edge.x1 = contour[i].x();
+        edge.y1 = contour[i].y();
+        edge.x2 = contour[(i + 1) % count].x();
+        edge.y2 = contour[(i + 1) % count].y();
         if (edge.x1 == edge.x2) {
             if (edge.y1 < edge.y2) {
                 edge.x1 -= width;
@@ -159,54 +357,162 @@ void paintComplexOutline(GraphicsContext& graphicsContext, const Vector<IntRect>
         }
     }
 
-    if (!count)
+    for (size_t i = 0; i < count; ++i)
+        jointWidths.push_back(adjustJoint(width, edges[first + i], edges[first + (i + 1) % count]));
+}
+
+// Whether the boundary of the outline's union passes through the inside of the edge's rect. An
+// edge is drawn within its rect, which otherwise lies inside the union. Where the union is
+// narrower than the outline next to a counterclockwise joint, the lengthened edge reaches past
+// the union's outer edge instead.
+bool outlineEdgeCrossesBoundary(const OutlineEdgeInfo& edge, const std::vector<std::vector<IntPoint>>& contours)
+{
+    for (const std::vector<IntPoint>& contour : contours) {
+        for (size_t i = 0, previous = contour.size() - 1; i < contour.size(); previous = i++) {
+            const IntPoint& a = contour[previous];
+            const IntPoint& b = contour[i];
+            if (a.x() == b.x()) {
+                if (a.x() > edge.x1 && a.x() < edge.x2
+                    && std::max(a.y(), b.y()) > edge.y1 && std::min(a.y(), b.y()) < edge.y2)
+                    return true;
+            } else if (a.y() > edge.y1 && a.y() < edge.y2
+                && std::max(a.x(), b.x()) > edge.x1 && std::min(a.x(), b.x()) < edge.x2) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void paintComplexOutline(GraphicsContext& graphicsContext, const std::vector<IntRect>& rects, const ComputedStyle& style, const Color& color)
+{
+    ASSERT(!style.outlineStyleIsAuto());
+
+    // Construct clockwise contours along the outer edge of the outline.
+    int width = style.outlineWidth();
+    int outset = style.outlineOffset() + style.outlineWidth();
+    std::vector<IntRect> inflatedRects;
+    inflatedRects.reserve(rects.size());
+    for (auto& r : rects) {
+        IntRect rect = r;
+        rect.inflate(outset);
+        inflatedRects.push_back(rect);
+    }
+    std::vector<std::vector<IntPoint>> contours;
+    computeUnionBoundary(inflatedRects, contours);
+    if (contours.empty())
         return;
 
+    std::vector<OutlineEdgeInfo> edges;
+    std::vector<int> jointWidths;
+    for (const std::vector<IntPoint>& contour : contours)
+        appendOutlineEdges(contour, width, edges, jointWidths);
+
+    // Only the rare outlines that are wider than their union somewhere pay for a clip. Unless the
+    // offset is very negative, every inflated rect is at least as thick as the outline is wide,
+    // and only the edges lengthened over a counterclockwise joint can get there.
+    bool onlyLengthenedEdges = 2 * outset >= width;
+    bool clipToUnion = false;
+    size_t first = 0;
+    for (const std::vector<IntPoint>& contour : contours) {
+        size_t count = contour.size();
+        for (size_t i = 0; i < count && !clipToUnion; ++i) {
+            bool lengthened = jointWidths[first + (i + count - 1) % count] < 0 || jointWidths[first + i] < 0;
+            if (lengthened || !onlyLengthenedEdges)
+                clipToUnion = outlineEdgeCrossesBoundary(edges[first + i], contours);
+        }
+        first += count;
+    }
+
+    GraphicsContextStateSaver stateSaver(graphicsContext, clipToUnion);
+    if (clipToUnion) {
+        SkPath unionPath;
+        for (const std::vector<IntPoint>& contour : contours) {
+            unionPath.moveTo(contour[0].x(), contour[0].y());
+            for (size_t i = 1; i < contour.size(); ++i)
+                unionPath.lineTo(contour[i].x(), contour[i].y());
+            unionPath.close();
+        }
+        graphicsContext.clipPath(unionPath, NotAntiAliased);
+    }
+
+    // Solid outlines are the common case: gather every edge into one path and fill it once.
+    // A single fill never blends a pixel twice, so translucent colors need no layer either.
+    bool batchEdges = style.outlineStyle() == BorderStyleSolid;
+    SkPath batchedPath;
+
     Color outlineColor = color;
-    bool useTransparencyLayer = color.hasAlpha();
+    bool useTransparencyLayer = !batchEdges && color.hasAlpha();
     if (useTransparencyLayer) {
         graphicsContext.beginLayer(static_cast<float>(color.alpha()) / 255);
         outlineColor = Color(outlineColor.red(), outlineColor.green(), outlineColor.blue());
     }
 
-    ASSERT(count >= 4 && edges.size() == count);
-    int firstAdjacentWidth = adjustJoint(width, edges.last(), edges.first());
+    // The other styles are drawn edge by edge, but their quads can still be collected.
+    if (!batchEdges)
+        graphicsContext.beginQuadBatch();
+
+    first = 0;
+    for (const std::vector<IntPoint>& contour : contours) {
+        size_t count = contour.size();
+        for (size_t i = 0; i < count; ++i) {
+            const OutlineEdgeInfo& edge = edges[first + i];
+            // The widths of the angled parts of the starting and ending joints of the edge.
+            int adjacentWidth1 = jointWidths[first + (i + count - 1) % count];
+            int adjacentWidth2 = jointWidths[first + i];
+            if (edge.side == BSLeft || edge.side == BSBottom)
+                std::swap(adjacentWidth1, adjacentWidth2);
+            if (batchEdges) {
+                FloatPoint quad[4];
+                solidBoxSideQuad(edge.x1, edge.y1, edge.x2, edge.y2, edge.side, adjacentWidth1, adjacentWidth2, quad);
+                addQuadToPath(batchedPath, quad);
+            } else {
+                ObjectPainter::drawLineForBoxSide(graphicsContext, edge.x1, edge.y1, edge.x2, edge.y2, edge.side, outlineColor, style.outlineStyle(), adjacentWidth1, adjacentWidth2, false);
+            }
+        }
+        first += count;
+    }
 
-    // The width of the angled part of starting and ending joint of the current edge.
-    int adjacentWidthStart = firstAdjacentWidth;
-    int adjacentWidthEnd;
-    for (size_t i = 0; i < count; ++i) {
-        OutlineEdgeInfo& edge = edges[i];
-        adjacentWidthEnd = i == count - 1 ? firstAdjacentWidth : adjustJoint(width, edge, edges[i + 1]);
-        int adjacentWidth1 = adjacentWidthStart;
-        int adjacentWidth2 = adjacentWidthEnd;
-        if (edge.side == BSLeft || edge.side == BSBottom)
-            std::swap(adjacentWidth1, adjacentWidth2);
-        ObjectPainter::drawLineForBoxSide(graphicsContext, edge.x1, edge.y1, edge.x2, edge.y2, edge.side, outlineColor, style.outlineStyle(), adjacentWidth1, adjacentWidth2, false);
-        adjacentWidthStart = adjacentWidthEnd;
+    if (!batchEdges)
+        graphicsContext.endQuadBatch();
+
+    if (batchEdges) {
+        SkPaint paint(graphicsContext.fillPaint());
+        paint.setAntiAlias(false);
+        paint.setColor(outlineColor.rgb());
+        graphicsContext.drawPath(batchedPath, paint);
     }
 
     if (useTransparencyLayer)
         graphicsContext.endLayer();
 }
-#endif
 
 void fillQuad(GraphicsContext& context, const FloatPoint quad[], const Color& color, bool antialias)
 {
-    SkPath path;
-    path.moveTo(quad[0]);
-    path.lineTo(quad[1]);
-    path.lineTo(quad[2]);
-    path.lineTo(quad[3]);
-    SkPaint paint(context.fillPaint());
-    paint.setAntiAlias(antialias);
-    paint.setColor(color.rgb());
-
-    context.drawPath(path, paint);
+    const SkPoint points[4] = { quad[0], quad[1], quad[2], quad[3] };
+    context.fillQuad(points, color, antialias);
 }
-#if 0
 } // namespace
 
+void ObjectPainter::paintOutlineRects(const PaintInfo& paintInfo, const std::vector<IntRect>& rects,
+    const ComputedStyle& style, const Color& color)
+{
+    if (rects.empty() || !style.hasOutline() || style.outlineStyleIsAuto())
+        return;
+
+    bool firstRectContainsAll = true;
+    for (const IntRect& rect : rects) {
+        firstRectContainsAll = firstRectContainsAll && rect.x() >= rects[0].x() && rect.y() >= rects[0].y()
+            && rect.maxX() <= rects[0].maxX() && rect.maxY() <= rects[0].maxY();
+    }
+    if (firstRectContainsAll) {
+        paintSingleRectangleOutline(paintInfo, rects[0], style, color);
+        return;
+    }
+    paintComplexOutline(paintInfo.context, rects, style, color);
+}
+#if 0
+
 void ObjectPainter::paintOutline(const PaintInfo& paintInfo, const LayoutPoint& paintOffset)
 {
     ASSERT(shouldPaintSelfOutline(paintInfo.phase));
@@ -362,6 +668,29 @@ void ObjectPainter::drawDashedOrDottedBoxSide(GraphicsContext& graphicsContext,
 {
     ASSERT(thickness > 0);
 
+    if (style == BorderStyleDotted) {
+        // Dots are centered on the side's midline, with the end dots tucked into the corners.
+        float halfThickness = thickness / 2.f;
+        FloatPoint line[2];
+        switch (side) {
+        case BSBottom:
+        case BSTop:
+            line[0] = FloatPoint(x1 + halfThickness, y1 + halfThickness);
+            line[1] = FloatPoint(x2 - halfThickness, y1 + halfThickness);
+            break;
+        case BSRight:
+        case BSLeft:
+            line[0] = FloatPoint(x1 + halfThickness, y1 + halfThickness);
+            line[1] = FloatPoint(x1 + halfThickness, y2 - halfThickness);
+            break;
+        }
+        bool wasAntialiased = graphicsContext.shouldAntialias();
+        graphicsContext.setShouldAntialias(antialias);
+        drawDottedPolyline(graphicsContext, line, 2, color, thickness);
+        graphicsContext.setShouldAntialias(wasAntialiased);
+        return;
+    }
+
     bool wasAntialiased = graphicsContext.shouldAntialias();
     StrokeStyle oldStrokeStyle = graphicsContext.getStrokeStyle();
     graphicsContext.setShouldAntialias(antialias);
@@ -387,6 +716,48 @@ void ObjectPainter::drawDashedOrDottedBoxSide(GraphicsContext& graphicsContext,
     graphicsContext.setStrokeStyle(oldStrokeStyle);
 }
 
+void ObjectPainter::drawDottedPolyline(GraphicsContext& graphicsContext, const FloatPoint polyline[], size_t count,
+    Color color, float thickness)
+{
+    ASSERT(count > 0);
+    ASSERT(thickness > 0);
+
+    float length = 0;
+    for (size_t i = 1; i < count; ++i)
+        length += sqrtf((polyline[i] - polyline[i - 1]).diagonalLengthSquared());
+
+    std::vector<SkPoint> dots;
+    if (length < thickness) {
+        // Not enough room for two dots; center a single one on the polyline.
+        dots.push_back(polyline[0] + (polyline[count - 1] - polyline[0]).scaledBy(0.5f));
+    } else {
+        // Aim for gaps as wide as the dots, stretched so that the last dot lands on the end point.
+        int gaps = std::max(1, static_cast<int>(roundf(length / (2 * thickness))));
+        float spacing = length / gaps;
+        dots.reserve(gaps + 1);
+        dots.push_back(polyline[0]);
+
+        float nextDot = spacing;
+        float segmentStart = 0;
+        for (size_t i = 1; i < count && static_cast<int>(dots.size()) < gaps; ++i) {
+            FloatSize delta = polyline[i] - polyline[i - 1];
+            float segmentLength = sqrtf(delta.diagonalLengthSquared());
+            if (!segmentLength)
+                continue;
+            while (static_cast<int>(dots.size()) < gaps && nextDot <= segmentStart + segmentLength) {
+                float t = (nextDot - segmentStart) / segmentLength;
+                dots.push_back(polyline[i - 1] + delta.scaledBy(t));
+                nextDot += spacing;
+            }
+            segmentStart += segmentLength;
+        }
+        dots.push_back(polyline[count - 1]);
+    }
+
+    graphicsContext.setStrokeColor(color);
+    graphicsContext.drawDots(dots.data(), dots.size(), thickness);
+}
+
 void ObjectPainter::drawDoubleBoxSide(GraphicsContext& graphicsContext, int x1, int y1, int x2, int y2,
     int length, BoxSide side, Color color, int thickness, int adjacentWidth1, int adjacentWidth2, bool antialias)
 {
@@ -510,45 +881,9 @@ void ObjectPainter::drawSolidBoxSide(GraphicsContext& graphicsContext, int x1, i
     ASSERT(x2 >= x1);
     ASSERT(y2 >= y1);
 
-    if (!adjacentWidth1 && !adjacentWidth2) {
-        // Tweak antialiasing to match the behavior of fillQuad();
-        // this matters for rects in transformed contexts.
-        bool wasAntialiased = graphicsContext.shouldAntialias();
-        if (antialias != wasAntialiased)
-            graphicsContext.setShouldAntialias(antialias);
-        graphicsContext.fillRect(IntRect(x1, y1, x2 - x1, y2 - y1), color);
-        if (antialias != wasAntialiased)
-            graphicsContext.setShouldAntialias(wasAntialiased);
-        return;
-    }
-
+    // Without adjacent widths the quad is a plain rect, which fillQuad() draws as one.
     FloatPoint quad[4];
-    switch (side) {
-    case BSTop:
-        quad[0] = FloatPoint(x1 + std::max(-adjacentWidth1, 0), y1);
-        quad[1] = FloatPoint(x1 + std::max(adjacentWidth1, 0), y2);
-        quad[2] = FloatPoint(x2 - std::max(adjacentWidth2, 0), y2);
-        quad[3] = FloatPoint(x2 - std::max(-adjacentWidth2, 0), y1);
-        break;
-    case BSBottom:
-        quad[0] = FloatPoint(x1 + std::max(adjacentWidth1, 0), y1);
-        quad[1] = FloatPoint(x1 + std::max(-adjacentWidth1, 0), y2);
-        quad[2] = FloatPoint(x2 - std::max(-adjacentWidth2, 0), y2);
-        quad[3] = FloatPoint(x2 - std::max(adjacentWidth2, 0), y1);
-        break;
-    case BSLeft:
-        quad[0] = FloatPoint(x1, y1 + std::max(-adjacentWidth1, 0));
-        quad[1] = FloatPoint(x1, y2 - std::max(-adjacentWidth2, 0));
-        quad[2] = FloatPoint(x2, y2 - std::max(adjacentWidth2, 0));
-        quad[3] = FloatPoint(x2, y1 + std::max(adjacentWidth1, 0));
-        break;
-    case BSRight:
-        quad[0] = FloatPoint(x1, y1 + std::max(adjacentWidth1, 0));
-        quad[1] = FloatPoint(x1, y2 - std::max(adjacentWidth2, 0));
-        quad[2] = FloatPoint(x2, y2 - std::max(-adjacentWidth2, 0));
-        quad[3] = FloatPoint(x2, y1 + std::max(-adjacentWidth1, 0));
-        break;
-    }
+    solidBoxSideQuad(x1, y1, x2, y2, side, adjacentWidth1, adjacentWidth2, quad);
 
     fillQuad(graphicsContext, quad, color, antialias);
 }
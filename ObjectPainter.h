@@ -9,11 +9,15 @@
 //#include "wtf/Allocator.h"
 //#include "wtf/Vector.h"
 #include "Color.h"
+#include <stddef.h>
+#include <vector>
 
 namespace blink {
 
 class Color;
+class FloatPoint;
 class GraphicsContext;
+class IntRect;
 class LayoutPoint;
 //class LayoutRect;
 class LayoutSize;
@@ -30,8 +34,16 @@ public:
     void paintInlineChildrenOutlines(const PaintInfo&, const LayoutPoint& paintOffset);
     void addPDFURLRectIfNeeded(const PaintInfo&, const LayoutPoint& paintOffset);
 
+    // Paints the outline of |style| around pixel snapped |rects|, the part of paintOutline() that
+    // doesn't need a layout object.
+    static void paintOutlineRects(const PaintInfo&, const std::vector<IntRect>& rects, const ComputedStyle&, const Color&);
+
     static void drawLineForBoxSide(GraphicsContext&, int x1, int y1, int x2, int y2, BoxSide, Color, EBorderStyle, int adjbw1, int adjbw2, bool antialias = false);
 
+    // Draws round dots of diameter |thickness| along the polyline, evenly spaced so that the
+    // first and last dots are centered on the polyline's end points.
+    static void drawDottedPolyline(GraphicsContext&, const FloatPoint polyline[], size_t count, Color, float thickness);
+
     // Paints the object atomically as if it created a new stacking context, for:
     // - inline blocks, inline tables, inline-level replaced elements (Section 7.2.1.4 in
     //   http://www.w3.org/TR/CSS2/zindex.html#painting-order),
@@ -0,0 +1,48 @@
+#include "PaintStats.h"
+
+namespace blink {
+
+bool PaintStats::s_enabled = false;
+unsigned PaintStats::s_borderFastPaths = 0;
+unsigned PaintStats::s_borderFallbacks[BorderFallbackCount];
+unsigned PaintStats::s_layers = 0;
+
+static const char* const borderFallbackNames[PaintStats::BorderFallbackCount] = {
+    "non-uniform color",
+    "non-uniform style",
+    "inner rect not renderable",
+    "not solid or double",
+    "partial edges",
+};
+
+void PaintStats::reset()
+{
+    s_borderFastPaths = 0;
+    for (int reason = 0; reason < BorderFallbackCount; ++reason)
+        s_borderFallbacks[reason] = 0;
+    s_layers = 0;
+}
+
+static double percentOf(unsigned count, unsigned total)
+{
+    return total ? 100.0 * count / total : 0.0;
+}
+
+void PaintStats::print(FILE* file)
+{
+    unsigned fallbacks = 0;
+    for (int reason = 0; reason < BorderFallbackCount; ++reason)
+        fallbacks += s_borderFallbacks[reason];
+    unsigned borders = s_borderFastPaths + fallbacks;
+
+    fprintf(file, "borders painted:               %8u\n", borders);
+    fprintf(file, "  fast path:                   %8u  %5.1f%%\n", s_borderFastPaths, percentOf(s_borderFastPaths, borders));
+    fprintf(file, "  fallback:                    %8u  %5.1f%%\n", fallbacks, percentOf(fallbacks, borders));
+    for (int reason = 0; reason < BorderFallbackCount; ++reason) {
+        fprintf(file, "    %-26s %8u  %5.1f%%\n", borderFallbackNames[reason], s_borderFallbacks[reason],
+            percentOf(s_borderFallbacks[reason], borders));
+    }
+    fprintf(file, "layers (beginLayer):           %8u\n", s_layers);
+}
+
+} // namespace blink
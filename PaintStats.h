@@ -0,0 +1,55 @@
+#ifndef PaintStats_h
+#define PaintStats_h
+
+#include <cstdio>
+
+namespace blink {
+
+// Opt-in counters that show how often painting takes its fast paths, and why it
+// doesn't when it falls back to the general code. Nothing is counted until
+// setEnabled(true) is called, so the cost when disabled is one branch per event.
+class PaintStats {
+public:
+    // Why BoxBorderPainter::paintBorderFastPath() declined a border, in the order
+    // the conditions are checked. Only the first failing condition is counted.
+    enum BorderFallback {
+        BorderNonUniformColor,
+        BorderNonUniformStyle,
+        BorderInnerNotRenderable,
+        BorderNonSolidStyle,
+        // Some sides are hidden and the border isn't a translucent, rectangular solid one.
+        BorderPartialEdges,
+        BorderFallbackCount
+    };
+
+    static bool isEnabled() { return s_enabled; }
+    static void setEnabled(bool enabled) { s_enabled = enabled; }
+    static void reset();
+    static void print(FILE*);
+
+    static void countBorderFastPath()
+    {
+        if (s_enabled)
+            ++s_borderFastPaths;
+    }
+    static void countBorderFallback(BorderFallback reason)
+    {
+        if (s_enabled)
+            ++s_borderFallbacks[reason];
+    }
+    static void countLayer()
+    {
+        if (s_enabled)
+            ++s_layers;
+    }
+
+private:
+    static bool s_enabled;
+    static unsigned s_borderFastPaths;
+    static unsigned s_borderFallbacks[BorderFallbackCount];
+    static unsigned s_layers;
+};
+
+} // namespace blink
+
+#endif // PaintStats_h
@@ -0,0 +1,502 @@
+// Headless border painting benchmarks. Borders are painted into a raster surface
+// and the average time per border is reported, along with the number of draw
+// calls and layers each border issues. The suite covers:
+//
+//  - a matrix of every EBorderStyle against uniform and mixed widths, uniform and
+//    mixed colors, opaque and translucent colors, square and rounded corners and
+//    small and large boxes,
+//  - two larger scenes of mixed borders,
+//  - single solid box sides of every orientation, as rects and as trapezoids,
+//  - the outer and inner rounded rects of many borders, computed one border at a
+//    time and with BorderGeometryBatch.
+//
+//   border_bench [iterations] [filter]
+//
+// Only rows whose label contains |filter| are run.
+
+#include "../include/core/SkCanvas.h"
+#include "../include/core/SkSurface.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "BoxBorderPainter.h"
+#include "BorderGeometryBatch.h"
+#include "GraphicsContext.h"
+#include "ComputedStyle.h"
+#include "CountingCanvas.h"
+#include "ObjectPainter.h"
+
+using namespace blink;
+using std::vector;
+
+static const int kWidth = 1024;
+static const int kHeight = 768;
+static const int kColumns = 16;
+static const int kRows = 16;
+static const int kManyBorders = 100000;
+static const int kBordersPerConfig = 64;
+static const int kBoxSides = 10000;
+static const int kRoundedBorders = 100000;
+
+static const SkColor kColors[] = {
+    0xFFFF0000, 0xFF00A000, 0xFF0000FF, 0xFF000000, 0xFFFF8000, 0xFF8000FF,
+};
+static const int kNumColors = sizeof(kColors) / sizeof(kColors[0]);
+
+static const EBorderStyle kStyles[] = {
+    BorderStyleSolid, BorderStyleDouble, BorderStyleGroove,
+    BorderStyleRidge, BorderStyleInset, BorderStyleOutset,
+};
+static const int kNumStyles = sizeof(kStyles) / sizeof(kStyles[0]);
+
+// Indexed by EBorderStyle.
+static const char* kStyleNames[] = {
+    "none", "hidden", "inset", "groove", "outset", "ridge", "dotted", "dashed", "solid", "double",
+};
+static const int kNumBorderStyles = sizeof(kStyleNames) / sizeof(kStyleNames[0]);
+
+static const char* gFilter = nullptr;
+
+struct BenchResult {
+    double nsPerItem;
+    double drawsPerItem;
+    double layersPerItem;
+};
+
+static void paintBorder(SkCanvas* canvas, const ComputedStyle& style, const SkRect& bounds)
+{
+    GraphicsContext context(canvas);
+    PaintInfo info(context);
+    LayoutRect borderRect = bounds;
+    BoxBorderPainter painter(borderRect, style, BackgroundBleedNone, true, true);
+    painter.paintBorder(info, borderRect);
+}
+
+// Paints |numItems| items with |paintItems| once into a counting canvas, then
+// times |iterations| passes over |canvas| after a warm-up pass.
+template <typename PaintItems>
+static BenchResult measure(SkCanvas* canvas, size_t numItems, int iterations, PaintItems paintItems)
+{
+    CountingCanvas counter(kWidth, kHeight);
+    paintItems(&counter);
+
+    paintItems(canvas);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++) {
+        canvas->clear(SK_ColorWHITE);
+        paintItems(canvas);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double items = static_cast<double>(numItems);
+    BenchResult result;
+    result.nsPerItem = std::chrono::duration<double, std::nano>(end - start).count() / (items * iterations);
+    result.drawsPerItem = counter.drawCount() / items;
+    result.layersPerItem = counter.count(CountingCanvas::SaveLayer) / items;
+    return result;
+}
+
+static bool shouldRun(const char* label)
+{
+    return !gFilter || strstr(label, gFilter);
+}
+
+static void printHeader(const char* unit)
+{
+    printf("%-52s %12s %12s %12s\n", "", unit, "draws", "layers");
+}
+
+static void printResult(const char* label, const BenchResult& result)
+{
+    printf("%-52s %12.1f %12.2f %12.2f\n", label, result.nsPerItem, result.drawsPerItem, result.layersPerItem);
+}
+
+static BenchResult runBorders(SkCanvas* canvas, const vector<ComputedStyle>& styles,
+    const vector<SkRect>& bounds, int iterations)
+{
+    return measure(canvas, styles.size(), iterations, [&](SkCanvas* target) {
+        for (size_t i = 0; i < styles.size(); i++)
+            paintBorder(target, styles[i], bounds[i]);
+    });
+}
+
+struct MatrixConfig {
+    EBorderStyle style;
+    bool mixedWidths;
+    bool mixedColors;
+    bool translucent;
+    bool rounded;
+    bool large;
+};
+
+static std::string matrixLabel(const MatrixConfig& config)
+{
+    char label[128];
+    snprintf(label, sizeof(label), "%-7s %-12s %-12s %-12s %-8s %s", kStyleNames[config.style],
+        config.mixedWidths ? "mixed-width" : "same-width", config.mixedColors ? "mixed-color" : "same-color",
+        config.translucent ? "translucent" : "opaque", config.rounded ? "rounded" : "square",
+        config.large ? "large" : "small");
+    return label;
+}
+
+static void buildMatrixScene(const MatrixConfig& config, vector<ComputedStyle>& styles, vector<SkRect>& bounds)
+{
+    styles.assign(kBordersPerConfig, ComputedStyle());
+    bounds.resize(kBordersPerConfig);
+
+    const int boxWidth = config.large ? 240 : 32;
+    const int boxHeight = config.large ? 160 : 24;
+    const int width = config.large ? 8 : 3;
+    const float radius = config.large ? 24 : 6;
+    const SkColor alpha = config.translucent ? 0x80000000 : 0xFF000000;
+    const int columns = kWidth / (boxWidth + 4);
+    const int rows = kHeight / (boxHeight + 4);
+
+    for (int i = 0; i < kBordersPerConfig; i++) {
+        ComputedStyle::BorderData& b = styles[i].m_border;
+
+        b.m_topStyle = b.m_rightStyle = b.m_bottomStyle = b.m_leftStyle = config.style;
+
+        b.m_topWidth = width;
+        b.m_rightWidth = config.mixedWidths ? width * 2 : width;
+        b.m_bottomWidth = config.mixedWidths ? width + 1 : width;
+        b.m_leftWidth = config.mixedWidths ? (width + 1) / 2 : width;
+
+        SkColor color = (kColors[i % kNumColors] & 0xFFFFFF) | alpha;
+        b.m_topColor = b.m_rightColor = b.m_bottomColor = b.m_leftColor = color;
+        if (config.mixedColors) {
+            b.m_rightColor = (kColors[(i + 1) % kNumColors] & 0xFFFFFF) | alpha;
+            b.m_bottomColor = (kColors[(i + 2) % kNumColors] & 0xFFFFFF) | alpha;
+            b.m_leftColor = (kColors[(i + 3) % kNumColors] & 0xFFFFFF) | alpha;
+        }
+
+        if (config.rounded)
+            b.m_topLeft = b.m_topRight = b.m_bottomLeft = b.m_bottomRight = FloatSize(radius, radius);
+
+        int cell = i % (columns * rows);
+        bounds[i] = SkRect::MakeXYWH((cell % columns) * (boxWidth + 4) + 2, (cell / columns) * (boxHeight + 4) + 2,
+            boxWidth, boxHeight);
+    }
+}
+
+static void runMatrix(SkCanvas* canvas, int iterations)
+{
+    printf("border matrix: %d borders x %d iterations per row\n", kBordersPerConfig, iterations);
+    printHeader("ns/border");
+
+    vector<ComputedStyle> styles;
+    vector<SkRect> bounds;
+    for (int style = 0; style < kNumBorderStyles; style++) {
+        for (int variant = 0; variant < 32; variant++) {
+            MatrixConfig config;
+            config.style = static_cast<EBorderStyle>(style);
+            config.mixedWidths = variant & 1;
+            config.mixedColors = variant & 2;
+            config.translucent = variant & 4;
+            config.rounded = variant & 8;
+            config.large = variant & 16;
+
+            std::string label = matrixLabel(config);
+            if (!shouldRun(label.c_str()))
+                continue;
+
+            buildMatrixScene(config, styles, bounds);
+            printResult(label.c_str(), runBorders(canvas, styles, bounds, iterations));
+        }
+    }
+}
+
+// Builds one style per cell. Every other cell mixes two styles, and the color
+// pattern changes from cell to cell, so the scene has both anti-aliased miters
+// (color changes) and non-anti-aliased ones (same color, different style).
+static void buildMixedStyleScene(vector<ComputedStyle>& styles, vector<SkRect>& bounds)
+{
+    styles.assign(kColumns * kRows, ComputedStyle());
+    bounds.resize(kColumns * kRows);
+
+    const float cellWidth = static_cast<float>(kWidth) / kColumns;
+    const float cellHeight = static_cast<float>(kHeight) / kRows;
+
+    for (int row = 0; row < kRows; row++) {
+        for (int column = 0; column < kColumns; column++) {
+            int i = row * kColumns + column;
+            ComputedStyle::BorderData& b = styles[i].m_border;
+
+            int width = 3 + i % 10;
+            b.m_topWidth = b.m_leftWidth = b.m_bottomWidth = b.m_rightWidth = width;
+
+            EBorderStyle style = kStyles[i % kNumStyles];
+            EBorderStyle otherStyle = i % 2 ? kStyles[(i + 1) % kNumStyles] : style;
+            b.m_topStyle = b.m_bottomStyle = style;
+            b.m_leftStyle = b.m_rightStyle = otherStyle;
+
+            // Cycle through one color for the whole border, one color per pair
+            // of adjacent sides, and a different color on every side.
+            SkColor color1 = kColors[i % kNumColors];
+            SkColor color2 = kColors[(i + 1) % kNumColors];
+            switch (i % 3) {
+            case 0:
+                b.m_topColor = b.m_rightColor = b.m_bottomColor = b.m_leftColor = color1;
+                break;
+            case 1:
+                b.m_topColor = b.m_rightColor = color1;
+                b.m_bottomColor = b.m_leftColor = color2;
+                break;
+            default:
+                b.m_topColor = color1;
+                b.m_rightColor = color2;
+                b.m_bottomColor = kColors[(i + 2) % kNumColors];
+                b.m_leftColor = kColors[(i + 3) % kNumColors];
+                break;
+            }
+
+            bounds[i] = SkRect::MakeXYWH(column * cellWidth + 4, row * cellHeight + 4,
+                cellWidth - 8, cellHeight - 8);
+        }
+    }
+}
+
+// Many small borders with a different, partly translucent color on every side.
+// These all take the complex path, so the cost is dominated by per-border setup
+// such as sorting sides into opacity groups.
+static void buildManyBordersScene(vector<ComputedStyle>& styles, vector<SkRect>& bounds)
+{
+    static const SkColor kAlphas[] = { 0xFF000000, 0x80000000, 0x40000000 };
+
+    styles.assign(kManyBorders, ComputedStyle());
+    bounds.resize(kManyBorders);
+    for (int i = 0; i < kManyBorders; i++) {
+        ComputedStyle::BorderData& b = styles[i].m_border;
+        b.m_topWidth = b.m_leftWidth = b.m_bottomWidth = b.m_rightWidth = 2 + i % 3;
+        b.m_topStyle = b.m_leftStyle = b.m_bottomStyle = b.m_rightStyle = BorderStyleSolid;
+
+        b.m_topColor = (kColors[i % kNumColors] & 0xFFFFFF) | kAlphas[i % 3];
+        b.m_rightColor = (kColors[(i + 1) % kNumColors] & 0xFFFFFF) | kAlphas[(i + 1) % 3];
+        b.m_bottomColor = (kColors[(i + 2) % kNumColors] & 0xFFFFFF) | kAlphas[(i / 3) % 3];
+        b.m_leftColor = (kColors[(i + 3) % kNumColors] & 0xFFFFFF) | kAlphas[(i / 9) % 3];
+
+        int cell = i % (64 * 64);
+        bounds[i] = SkRect::MakeXYWH((cell % 64) * 16, (cell / 64) * 12, 14, 10);
+    }
+}
+
+static void runScenes(SkCanvas* canvas, int iterations)
+{
+    printf("scenes: %d iterations (x10 for the mixed-style scene)\n", iterations);
+    printHeader("ns/border");
+
+    vector<ComputedStyle> styles;
+    vector<SkRect> bounds;
+
+    if (shouldRun("scene mixed-style")) {
+        buildMixedStyleScene(styles, bounds);
+        printResult("scene mixed-style", runBorders(canvas, styles, bounds, iterations * 10));
+    }
+
+    if (shouldRun("scene 100k-mixed-color")) {
+        buildManyBordersScene(styles, bounds);
+        printResult("scene 100k-mixed-color", runBorders(canvas, styles, bounds, iterations));
+    }
+}
+
+// Paints single solid box sides, which reach fillQuad() as rects when neither
+// adjacent side is mitered and as trapezoids otherwise.
+static void runBoxSides(SkCanvas* canvas, int iterations)
+{
+    static const BoxSide kSides[] = { BSTop, BSRight, BSBottom, BSLeft };
+    static const char* kSideNames[] = { "top", "right", "bottom", "left" };
+    static const int kLength = 40;
+    static const int kThickness = 4;
+
+    printf("solid box sides: %d sides x %d iterations\n", kBoxSides, iterations);
+    printHeader("ns/side");
+
+    for (int i = 0; i < 4; i++) {
+        for (int adjacentWidth = 0; adjacentWidth <= kThickness; adjacentWidth += kThickness) {
+            char label[64];
+            snprintf(label, sizeof(label), "side %-6s %s", kSideNames[i], adjacentWidth ? "trapezoid" : "rect");
+            if (!shouldRun(label))
+                continue;
+
+            BoxSide side = kSides[i];
+            bool horizontal = side == BSTop || side == BSBottom;
+            int width = horizontal ? kLength : kThickness;
+            int height = horizontal ? kThickness : kLength;
+            int columns = kWidth / (width + 2);
+
+            BenchResult result = measure(canvas, kBoxSides, iterations, [&](SkCanvas* target) {
+                GraphicsContext context(target);
+                for (int j = 0; j < kBoxSides; j++) {
+                    int x = (j % columns) * (width + 2);
+                    int y = (j / columns) * (height + 2) % kHeight;
+                    ObjectPainter::drawLineForBoxSide(context, x, y, x + width, y + height, side,
+                        kColors[j % kNumColors], BorderStyleSolid, adjacentWidth, adjacentWidth, true);
+                }
+            });
+            printResult(label, result);
+        }
+    }
+}
+
+// Rounded borders with fractional bounds and a mix of radii that fit and radii
+// that have to be scaled down, so every branch of the radii computation is taken.
+static void buildRoundedScene(vector<ComputedStyle>& styles, vector<SkRect>& bounds)
+{
+    styles.assign(kRoundedBorders, ComputedStyle());
+    bounds.resize(kRoundedBorders);
+    for (int i = 0; i < kRoundedBorders; i++) {
+        ComputedStyle::BorderData& b = styles[i].m_border;
+        b.m_topWidth = 1 + i % 4;
+        b.m_rightWidth = 1 + i % 3;
+        b.m_bottomWidth = 1 + i % 5;
+        b.m_leftWidth = 2;
+        b.m_topStyle = b.m_leftStyle = b.m_bottomStyle = b.m_rightStyle = BorderStyleSolid;
+        b.m_topColor = b.m_rightColor = b.m_bottomColor = b.m_leftColor = kColors[i % kNumColors];
+
+        float radius = 2 + i % 23;
+        b.m_topLeft = FloatSize(radius, radius);
+        b.m_topRight = FloatSize(radius * 1.5f, radius);
+        b.m_bottomLeft = FloatSize(i % 7 ? radius : 0, radius);
+        b.m_bottomRight = FloatSize(radius, radius * 0.5f);
+
+        int cell = i % (32 * 32);
+        bounds[i] = SkRect::MakeXYWH((cell % 32) * 32 + 0.25f * (i % 4), (cell / 32) * 24 + 0.5f * (i % 2),
+            20 + i % 11, 16 + i % 7);
+    }
+}
+
+static bool sameRoundedRect(const FloatRoundedRect& a, const FloatRoundedRect& b)
+{
+    const FloatRoundedRect::Radii& x = a.getRadii();
+    const FloatRoundedRect::Radii& y = b.getRadii();
+    return a.rect() == b.rect() && x.topLeft() == y.topLeft() && x.topRight() == y.topRight()
+        && x.bottomLeft() == y.bottomLeft() && x.bottomRight() == y.bottomRight();
+}
+
+template <typename Compute>
+static double timeGeometry(size_t numItems, int iterations, Compute compute)
+{
+    compute();
+    auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++)
+        compute();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(numItems) * iterations);
+}
+
+static void printGeometryResult(const char* label, double nsPerItem)
+{
+    printf("%-52s %12.1f %12s %12s\n", label, nsPerItem, "-", "-");
+}
+
+// Compares computing the outer and inner rounded rects one border at a time, as
+// BoxBorderPainter does, with BorderGeometryBatch, and then painting the borders
+// with each.
+static void runGeometry(SkCanvas* canvas, int iterations)
+{
+    vector<ComputedStyle> styles;
+    vector<SkRect> bounds;
+    buildRoundedScene(styles, bounds);
+    const size_t count = styles.size();
+
+    BorderGeometryBatch batch;
+    batch.reserve(count);
+    for (size_t i = 0; i < count; i++)
+        batch.add(bounds[i], styles[i]);
+    batch.compute();
+
+    int mismatches = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!sameRoundedRect(batch.outer(i), styles[i].getRoundedBorderFor(bounds[i]))
+            || !sameRoundedRect(batch.inner(i), styles[i].getRoundedInnerBorderFor(bounds[i])))
+            mismatches++;
+    }
+
+    printf("rounded border geometry: %zu borders x %d iterations, batch uses %s, %d mismatches\n",
+        count, iterations, BorderGeometryBatch::instructionSet(), mismatches);
+    printHeader("ns/border");
+
+    // Keeps the per-border results alive.
+    float sink = 0;
+
+    if (shouldRun("geometry per-border")) {
+        printGeometryResult("geometry per-border", timeGeometry(count, iterations, [&]() {
+            for (size_t i = 0; i < count; i++) {
+                LayoutRect borderRect = bounds[i];
+                sink += styles[i].getRoundedBorderFor(borderRect).getRadii().topLeft().width();
+                sink += styles[i].getRoundedInnerBorderFor(borderRect).getRadii().topLeft().width();
+            }
+        }));
+    }
+
+    if (shouldRun("geometry batch add+compute")) {
+        printGeometryResult("geometry batch add+compute", timeGeometry(count, iterations, [&]() {
+            batch.clear();
+            for (size_t i = 0; i < count; i++)
+                batch.add(bounds[i], styles[i]);
+            batch.compute();
+            sink += batch.outer(count - 1).getRadii().topLeft().width();
+        }));
+    }
+
+    if (shouldRun("geometry batch computeScalar")) {
+        printGeometryResult("geometry batch computeScalar", timeGeometry(count, iterations, [&]() {
+            batch.computeScalar();
+            sink += batch.outer(count - 1).getRadii().topLeft().width();
+        }));
+    }
+
+    if (shouldRun("geometry batch compute")) {
+        printGeometryResult("geometry batch compute", timeGeometry(count, iterations, [&]() {
+            batch.compute();
+            sink += batch.outer(count - 1).getRadii().topLeft().width();
+        }));
+    }
+
+    if (shouldRun("paint rounded per-border"))
+        printResult("paint rounded per-border", runBorders(canvas, styles, bounds, iterations));
+
+    if (shouldRun("paint rounded batched")) {
+        BenchResult result = measure(canvas, count, iterations, [&](SkCanvas* target) {
+            batch.clear();
+            for (size_t i = 0; i < count; i++)
+                batch.add(bounds[i], styles[i]);
+            batch.compute();
+
+            GraphicsContext context(target);
+            PaintInfo info(context);
+            for (size_t i = 0; i < count; i++) {
+                BoxBorderPainter painter(styles[i], BackgroundBleedNone, batch.outer(i), batch.inner(i));
+                painter.paintBorder(info, bounds[i]);
+            }
+        });
+        printResult("paint rounded batched", result);
+    }
+
+    if (sink == -1)
+        printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 20;
+    if (iterations <= 0)
+        iterations = 1;
+    if (argc > 2)
+        gFilter = argv[2];
+
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(kWidth, kHeight);
+    SkCanvas* canvas = surface->getCanvas();
+
+    runMatrix(canvas, iterations);
+    runScenes(canvas, iterations);
+    runBoxSides(canvas, iterations);
+    runGeometry(canvas, iterations);
+    return 0;
+}
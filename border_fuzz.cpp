@@ -0,0 +1,532 @@
+// Headless equivalence checks for the optimized border painting paths. Every random
+// case is painted twice into raster bitmaps, once through a reference path and once
+// through the optimized one, and the pixels are compared. The checks are:
+//
+//  - border: borders of every style, width, color and radius painted with the rounded
+//    rects from BorderGeometryBatch and the quad fast paths on, against per-border
+//    ComputedStyle geometry with the fast paths off. The rounded rects themselves must
+//    match exactly.
+//  - side: ObjectPainter::drawLineForBoxSide() of every style inside a quad batch,
+//    against the same calls with the quad fast paths off.
+//  - quad: GraphicsContext::fillQuad() of rects, trapezoids and general quads inside a
+//    quad batch, against drawing every quad as a path.
+//  - outline: solid outlines around sets of rects from ObjectPainter::paintOutlineRects(),
+//    against the band along the edge of the rects' union, computed with SkRegion.
+//
+//   border_fuzz [-n cases] [-s seed] [-c case] [-t tolerance] [-p pixels] [-d dir] [check...]
+//
+// A case fails when more than |pixels| pixels (default 0) differ by more than
+// |tolerance| (default 8) in some channel. Failing cases are listed with their number,
+// and -c reruns just that case with the same seed. With -d, the reference, optimized
+// and diff images of failing cases are written to |dir| as PNG files.
+
+#include "../include/core/SkBitmap.h"
+#include "../include/core/SkCanvas.h"
+#include "../include/core/SkData.h"
+#include "../include/core/SkImage.h"
+#include "../include/core/SkPath.h"
+#include "../include/core/SkRegion.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "BoxBorderPainter.h"
+#include "BorderGeometryBatch.h"
+#include "GraphicsContext.h"
+#include "ComputedStyle.h"
+#include "ObjectPainter.h"
+
+using namespace blink;
+using std::vector;
+
+static const int kWidth = 256;
+static const int kHeight = 256;
+
+static const SkColor kColors[] = {
+    0xFFFF0000, 0xFF00A000, 0xFF0000FF, 0xFF000000, 0xFFFF8000, 0xFF8000FF,
+};
+static const int kNumColors = sizeof(kColors) / sizeof(kColors[0]);
+
+// Small and self-contained, so that a seed gives the same cases everywhere.
+class Random {
+public:
+    explicit Random(uint32_t seed)
+        : m_state(seed ? seed : 0x9E3779B9)
+    {
+    }
+
+    uint32_t next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 17;
+        m_state ^= m_state << 5;
+        return m_state;
+    }
+
+    // Inclusive of both ends.
+    int range(int low, int high) { return low + static_cast<int>(next() % static_cast<uint32_t>(high - low + 1)); }
+    bool chance(int percent) { return range(0, 99) < percent; }
+    // Multiples of a quarter pixel, so that snapping rounds both ways and hits halves.
+    float quarterPixels(int low, int high) { return range(low * 4, high * 4) / 4.f; }
+
+    Color color()
+    {
+        static const SkColor kAlphas[] = { 0xFF000000, 0xFF000000, 0x80000000, 0x40000000 };
+        return Color((kColors[range(0, kNumColors - 1)] & 0xFFFFFF) | kAlphas[range(0, 3)]);
+    }
+
+private:
+    uint32_t m_state;
+};
+
+// Paints one random case into both canvases. Returns false, with the reason in
+// |failure|, if the case already failed on something other than pixels.
+typedef bool (*PaintCase)(Random&, SkCanvas* reference, SkCanvas* optimized, std::string& failure);
+
+static bool sameRoundedRect(const FloatRoundedRect& a, const FloatRoundedRect& b)
+{
+    const FloatRoundedRect::Radii& x = a.getRadii();
+    const FloatRoundedRect::Radii& y = b.getRadii();
+    return a.rect() == b.rect() && x.topLeft() == y.topLeft() && x.topRight() == y.topRight()
+        && x.bottomLeft() == y.bottomLeft() && x.bottomRight() == y.bottomRight();
+}
+
+static void randomBorder(Random& random, ComputedStyle& style, LayoutRect& rect)
+{
+    static const EBorderStyle kStyles[] = {
+        BorderStyleNone, BorderStyleHidden, BorderStyleInset, BorderStyleGroove, BorderStyleOutset,
+        BorderStyleRidge, BorderStyleDotted, BorderStyleDashed, BorderStyleSolid, BorderStyleDouble,
+    };
+    static const int kNumStyles = sizeof(kStyles) / sizeof(kStyles[0]);
+
+    ComputedStyle::BorderData& b = style.m_border;
+    b = ComputedStyle::BorderData();
+
+    // Uniform borders take the fast paths, so make them common.
+    bool uniformWidth = random.chance(50);
+    bool uniformStyle = random.chance(50);
+    bool uniformColor = random.chance(50);
+    int widths[4];
+    EBorderStyle styles[4];
+    Color colors[4];
+    for (int side = 0; side < 4; side++) {
+        widths[side] = uniformWidth && side ? widths[0] : (random.chance(15) ? 0 : random.range(1, 12));
+        styles[side] = uniformStyle && side ? styles[0] : kStyles[random.range(0, kNumStyles - 1)];
+        colors[side] = uniformColor && side ? colors[0] : random.color();
+    }
+    b.m_topWidth = widths[BSTop];
+    b.m_rightWidth = widths[BSRight];
+    b.m_bottomWidth = widths[BSBottom];
+    b.m_leftWidth = widths[BSLeft];
+    b.m_topStyle = styles[BSTop];
+    b.m_rightStyle = styles[BSRight];
+    b.m_bottomStyle = styles[BSBottom];
+    b.m_leftStyle = styles[BSLeft];
+    b.m_topColor = colors[BSTop];
+    b.m_rightColor = colors[BSRight];
+    b.m_bottomColor = colors[BSBottom];
+    b.m_leftColor = colors[BSLeft];
+
+    rect = LayoutRect(random.quarterPixels(0, 120), random.quarterPixels(0, 120),
+        random.quarterPixels(4, 130), random.quarterPixels(4, 130));
+
+    if (random.chance(50)) {
+        // Sometimes larger than the box, so that the radii have to be scaled down.
+        int maxRadius = random.chance(30) ? 120 : 30;
+        FloatSize* corners[] = { &b.m_topLeft, &b.m_topRight, &b.m_bottomLeft, &b.m_bottomRight };
+        for (FloatSize* corner : corners) {
+            if (random.chance(75))
+                *corner = FloatSize(random.quarterPixels(1, maxRadius), random.quarterPixels(1, maxRadius));
+        }
+    }
+}
+
+static bool paintBorderCase(Random& random, SkCanvas* reference, SkCanvas* optimized, std::string& failure)
+{
+    size_t count = random.range(1, 4);
+    vector<ComputedStyle> styles(count);
+    vector<LayoutRect> rects(count);
+    for (size_t i = 0; i < count; i++)
+        randomBorder(random, styles[i], rects[i]);
+
+    BorderGeometryBatch batch;
+    for (size_t i = 0; i < count; i++)
+        batch.add(rects[i], styles[i]);
+    batch.compute();
+
+    bool geometryMatches = true;
+    for (size_t i = 0; i < count; i++) {
+        if (!sameRoundedRect(batch.outer(i), styles[i].getRoundedBorderFor(rects[i]))
+            || !sameRoundedRect(batch.inner(i), styles[i].getRoundedInnerBorderFor(rects[i]))) {
+            failure = "BorderGeometryBatch rounded rects differ from ComputedStyle";
+            geometryMatches = false;
+        }
+    }
+
+    GraphicsContext referenceContext(reference);
+    referenceContext.setQuadFastPathsEnabled(false);
+    PaintInfo referenceInfo(referenceContext);
+    for (size_t i = 0; i < count; i++) {
+        BoxBorderPainter painter(rects[i], styles[i], BackgroundBleedNone, true, true);
+        painter.paintBorder(referenceInfo, rects[i]);
+    }
+
+    GraphicsContext optimizedContext(optimized);
+    PaintInfo optimizedInfo(optimizedContext);
+    for (size_t i = 0; i < count; i++) {
+        BoxBorderPainter painter(styles[i], BackgroundBleedNone, batch.outer(i), batch.inner(i));
+        painter.paintBorder(optimizedInfo, rects[i]);
+    }
+    return geometryMatches;
+}
+
+static bool paintSideCase(Random& random, SkCanvas* reference, SkCanvas* optimized, std::string&)
+{
+    static const EBorderStyle kStyles[] = {
+        BorderStyleInset, BorderStyleGroove, BorderStyleOutset, BorderStyleRidge,
+        BorderStyleDotted, BorderStyleDashed, BorderStyleSolid, BorderStyleDouble,
+    };
+    static const int kNumStyles = sizeof(kStyles) / sizeof(kStyles[0]);
+
+    GraphicsContext referenceContext(reference);
+    referenceContext.setQuadFastPathsEnabled(false);
+    GraphicsContext optimizedContext(optimized);
+    optimizedContext.beginQuadBatch();
+
+    int count = random.range(1, 6);
+    for (int i = 0; i < count; i++) {
+        BoxSide side = static_cast<BoxSide>(random.range(BSTop, BSLeft));
+        EBorderStyle style = kStyles[random.range(0, kNumStyles - 1)];
+        int thickness = random.range(1, 10);
+        int length = random.range(1, 120);
+        int adjacentWidth1 = random.range(-thickness, thickness);
+        int adjacentWidth2 = random.range(-thickness, thickness);
+        bool antialias = random.chance(50);
+        Color color = random.color();
+
+        int x1 = random.range(10, 120);
+        int y1 = random.range(10, 120);
+        bool horizontal = side == BSTop || side == BSBottom;
+        int x2 = x1 + (horizontal ? length : thickness);
+        int y2 = y1 + (horizontal ? thickness : length);
+
+        ObjectPainter::drawLineForBoxSide(referenceContext, x1, y1, x2, y2, side, color, style,
+            adjacentWidth1, adjacentWidth2, antialias);
+        ObjectPainter::drawLineForBoxSide(optimizedContext, x1, y1, x2, y2, side, color, style,
+            adjacentWidth1, adjacentWidth2, antialias);
+    }
+
+    optimizedContext.endQuadBatch();
+    return true;
+}
+
+// Fills |quad| in clockwise order: a rect, an axis-aligned trapezoid like a mitered box
+// side, or a general convex quad.
+static void randomQuad(Random& random, SkPoint quad[4])
+{
+    float x = random.range(10, 150);
+    float y = random.range(10, 150);
+    float width = random.range(1, 90);
+    float height = random.range(1, 90);
+    if (random.chance(50)) {
+        x = random.quarterPixels(10, 150);
+        y = random.quarterPixels(10, 150);
+        width = random.quarterPixels(1, 90);
+        height = random.quarterPixels(1, 90);
+    }
+
+    switch (random.range(0, 2)) {
+    case 0:
+        quad[0] = SkPoint::Make(x, y);
+        quad[1] = SkPoint::Make(x + width, y);
+        quad[2] = SkPoint::Make(x + width, y + height);
+        quad[3] = SkPoint::Make(x, y + height);
+        break;
+    case 1: {
+        // Shorten one of the parallel edges at either end, as a miter does.
+        float inset1 = random.range(0, 100) * 0.005f * width;
+        float inset2 = random.range(0, 100) * 0.005f * width;
+        if (random.chance(50)) {
+            quad[0] = SkPoint::Make(x, y);
+            quad[1] = SkPoint::Make(x + width, y);
+            quad[2] = SkPoint::Make(x + width - inset2, y + height);
+            quad[3] = SkPoint::Make(x + inset1, y + height);
+        } else {
+            inset1 = random.range(0, 100) * 0.005f * height;
+            inset2 = random.range(0, 100) * 0.005f * height;
+            quad[0] = SkPoint::Make(x, y + inset1);
+            quad[1] = SkPoint::Make(x + width, y);
+            quad[2] = SkPoint::Make(x + width, y + height);
+            quad[3] = SkPoint::Make(x, y + height - inset2);
+        }
+        break;
+    }
+    default:
+        // One point per quadrant around the center keeps the quad convex and clockwise.
+        quad[0] = SkPoint::Make(x + random.quarterPixels(0, 20), y + random.quarterPixels(0, 20));
+        quad[1] = SkPoint::Make(x + width + 40 - random.quarterPixels(0, 20), y + random.quarterPixels(0, 20));
+        quad[2] = SkPoint::Make(x + width + 40 - random.quarterPixels(0, 20), y + height + 40 - random.quarterPixels(0, 20));
+        quad[3] = SkPoint::Make(x + random.quarterPixels(0, 20), y + height + 40 - random.quarterPixels(0, 20));
+        break;
+    }
+}
+
+static bool paintQuadCase(Random& random, SkCanvas* reference, SkCanvas* optimized, std::string&)
+{
+    GraphicsContext optimizedContext(optimized);
+    optimizedContext.beginQuadBatch();
+
+    int count = random.range(1, 8);
+    for (int i = 0; i < count; i++) {
+        SkPoint quad[4];
+        randomQuad(random, quad);
+        Color color = random.color();
+        bool antialias = random.chance(50);
+
+        SkPath path;
+        path.moveTo(quad[0]);
+        path.lineTo(quad[1]);
+        path.lineTo(quad[2]);
+        path.lineTo(quad[3]);
+        path.close();
+        SkPaint paint;
+        paint.setAntiAlias(antialias);
+        paint.setColor(color.rgb());
+        reference->drawPath(path, paint);
+
+        optimizedContext.fillQuad(quad, color, antialias);
+    }
+
+    optimizedContext.endQuadBatch();
+    return true;
+}
+
+// The pixels within |width| of the edge of |region|: the region minus its erosion,
+// which is what is left after growing its complement by |width| in every direction.
+static SkRegion edgeBand(const SkRegion& region, int width)
+{
+    SkIRect bounds = region.getBounds();
+    bounds.outset(width + 1, width + 1);
+    SkRegion outside(bounds);
+    outside.op(region, SkRegion::kDifference_Op);
+
+    SkRegion grownOutside;
+    for (SkRegion::Iterator it(outside); !it.done(); it.next()) {
+        SkIRect rect = it.rect();
+        rect.outset(width, width);
+        grownOutside.op(rect, SkRegion::kUnion_Op);
+    }
+
+    SkRegion band(region);
+    band.op(grownOutside, SkRegion::kIntersect_Op);
+    return band;
+}
+
+static bool paintOutlineCase(Random& random, SkCanvas* reference, SkCanvas* optimized, std::string&)
+{
+    ComputedStyle style;
+    style.m_outline.m_width = random.range(1, 6);
+    style.m_outline.m_offset = random.range(0, 3);
+    style.m_outline.m_style = BorderStyleSolid;
+    style.m_outline.m_color = random.color();
+
+    // Rects in a small area, so that they overlap, touch and leave holes.
+    vector<IntRect> rects(random.range(1, 4));
+    for (IntRect& rect : rects)
+        rect = IntRect(random.range(20, 120), random.range(20, 120), random.range(1, 80), random.range(1, 80));
+
+    int outset = style.outlineOffset() + style.outlineWidth();
+    SkRegion outer;
+    for (const IntRect& rect : rects) {
+        outer.op(SkIRect::MakeXYWH(rect.x() - outset, rect.y() - outset,
+            rect.width() + 2 * outset, rect.height() + 2 * outset), SkRegion::kUnion_Op);
+    }
+    SkPaint paint;
+    paint.setColor(style.outlineColor().rgb());
+    reference->drawRegion(edgeBand(outer, style.outlineWidth()), paint);
+
+    GraphicsContext optimizedContext(optimized);
+    PaintInfo optimizedInfo(optimizedContext);
+    ObjectPainter::paintOutlineRects(optimizedInfo, rects, style, style.outlineColor());
+    return true;
+}
+
+struct Check {
+    const char* name;
+    PaintCase paintCase;
+};
+
+static const Check kChecks[] = {
+    { "border", paintBorderCase },
+    { "side", paintSideCase },
+    { "quad", paintQuadCase },
+    { "outline", paintOutlineCase },
+};
+static const int kNumChecks = sizeof(kChecks) / sizeof(kChecks[0]);
+
+struct Difference {
+    int pixels;
+    int maxChannel;
+    int x;
+    int y;
+};
+
+static int channelDifference(SkColor a, SkColor b)
+{
+    int result = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+        result = std::max(result, abs(static_cast<int>((a >> shift) & 0xFF) - static_cast<int>((b >> shift) & 0xFF)));
+    return result;
+}
+
+// Counts the pixels that differ by more than |tolerance| and, when |diff| is given,
+// marks them red on a faded copy of |reference|.
+static Difference compare(const SkBitmap& reference, const SkBitmap& optimized, int tolerance, SkBitmap* diff)
+{
+    Difference result = { 0, 0, -1, -1 };
+    for (int y = 0; y < reference.height(); y++) {
+        for (int x = 0; x < reference.width(); x++) {
+            int difference = channelDifference(*reference.getAddr32(x, y), *optimized.getAddr32(x, y));
+            if (difference > result.maxChannel) {
+                result.maxChannel = difference;
+                result.x = x;
+                result.y = y;
+            }
+            if (difference > tolerance)
+                result.pixels++;
+            if (diff) {
+                uint32_t faded = 0xFF000000 | ((*reference.getAddr32(x, y) >> 2) & 0x3F3F3F) | 0xC0C0C0;
+                *diff->getAddr32(x, y) = difference > tolerance ? 0xFFFF0000 : (difference ? 0xFFFFC000 : faded);
+            }
+        }
+    }
+    return result;
+}
+
+static void writePNG(const SkBitmap& bitmap, const std::string& path)
+{
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+    sk_sp<SkData> png(image->encode(SkEncodedImageFormat::kPNG, 100));
+    if (!png) {
+        fprintf(stderr, "could not encode %s\n", path.c_str());
+        return;
+    }
+    std::ofstream(path, std::ios::out | std::ios::binary).write(static_cast<const char*>(png->data()), png->size());
+}
+
+// Every case gets its own generator, so that a single case can be rerun with -c.
+static uint32_t caseSeed(uint32_t seed, int check, int index)
+{
+    return seed * 2654435761u ^ (check + 1) * 40503u ^ (index + 1) * 2246822519u;
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: border_fuzz [-n cases] [-s seed] [-c case] [-t tolerance] [-p pixels] [-d dir] [check...]\n");
+    fprintf(stderr, "checks:");
+    for (const Check& check : kChecks)
+        fprintf(stderr, " %s", check.name);
+    fprintf(stderr, "\n");
+    exit(2);
+}
+
+int main(int argc, char** argv)
+{
+    int cases = 1000;
+    uint32_t seed = 1;
+    int onlyCase = -1;
+    int tolerance = 8;
+    int allowedPixels = 0;
+    const char* dumpDirectory = nullptr;
+    vector<bool> enabled(kNumChecks, true);
+    bool checksNamed = false;
+
+    for (int n = 1; n < argc; n++) {
+        bool hasValue = n + 1 < argc;
+        if (strcmp(argv[n], "-n") == 0 && hasValue) {
+            cases = atoi(argv[++n]);
+        } else if (strcmp(argv[n], "-s") == 0 && hasValue) {
+            seed = static_cast<uint32_t>(strtoul(argv[++n], nullptr, 10));
+        } else if (strcmp(argv[n], "-c") == 0 && hasValue) {
+            onlyCase = atoi(argv[++n]);
+        } else if (strcmp(argv[n], "-t") == 0 && hasValue) {
+            tolerance = atoi(argv[++n]);
+        } else if (strcmp(argv[n], "-p") == 0 && hasValue) {
+            allowedPixels = atoi(argv[++n]);
+        } else if (strcmp(argv[n], "-d") == 0 && hasValue) {
+            dumpDirectory = argv[++n];
+        } else if (argv[n][0] != '-') {
+            if (!checksNamed)
+                enabled.assign(kNumChecks, false);
+            checksNamed = true;
+            int i = 0;
+            while (i < kNumChecks && strcmp(kChecks[i].name, argv[n]))
+                i++;
+            if (i == kNumChecks)
+                usage();
+            enabled[i] = true;
+        } else {
+            usage();
+        }
+    }
+
+    SkBitmap reference;
+    SkBitmap optimized;
+    SkBitmap diff;
+    reference.allocN32Pixels(kWidth, kHeight);
+    optimized.allocN32Pixels(kWidth, kHeight);
+    diff.allocN32Pixels(kWidth, kHeight);
+
+    int totalFailures = 0;
+    for (int check = 0; check < kNumChecks; check++) {
+        if (!enabled[check])
+            continue;
+
+        int failures = 0;
+        int first = onlyCase >= 0 ? onlyCase : 0;
+        int end = onlyCase >= 0 ? onlyCase + 1 : cases;
+        for (int index = first; index < end; index++) {
+            reference.eraseColor(SK_ColorWHITE);
+            optimized.eraseColor(SK_ColorWHITE);
+
+            Random random(caseSeed(seed, check, index));
+            std::string failure;
+            bool passed;
+            {
+                SkCanvas referenceCanvas(reference);
+                SkCanvas optimizedCanvas(optimized);
+                passed = kChecks[check].paintCase(random, &referenceCanvas, &optimizedCanvas, failure);
+            }
+
+            Difference difference = compare(reference, optimized, tolerance, dumpDirectory ? &diff : nullptr);
+            if (difference.pixels > allowedPixels) {
+                char message[128];
+                snprintf(message, sizeof(message), "%d pixels differ by more than %d, up to %d at (%d, %d)",
+                    difference.pixels, tolerance, difference.maxChannel, difference.x, difference.y);
+                failure = failure.empty() ? message : failure + "; " + message;
+                passed = false;
+            }
+            if (passed)
+                continue;
+
+            failures++;
+            printf("%s case %d: %s\n", kChecks[check].name, index, failure.c_str());
+            if (dumpDirectory) {
+                std::string prefix = std::string(dumpDirectory) + "/" + kChecks[check].name + "-" + std::to_string(index);
+                writePNG(reference, prefix + "-reference.png");
+                writePNG(optimized, prefix + "-optimized.png");
+                writePNG(diff, prefix + "-diff.png");
+            }
+        }
+
+        printf("%-8s %d cases, %d failed\n", kChecks[check].name, end - first, failures);
+        totalFailures += failures;
+    }
+
+    return totalFailures ? 1 : 0;
+}
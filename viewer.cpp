@@ -10,6 +10,8 @@
 #include "../include/core/SkStream.h"
 
 #include "../include/core/SkData.h"
+#include "../include/core/SkImage.h"
+#include "../include/core/SkPixmap.h"
 #include "../include/core/SkSurface.h"
 #include "../include/core/SkRefCnt.h"
 #include "../include/effects/SkGradientShader.h"
@@ -21,6 +23,8 @@
 #include "../include/core/SkEncodedImageFormat.h"
 #include "../tools/Resources.h"
 #include "yaml.h"
+#include "CountingCanvas.h"
+#include "PaintStats.h"
 
 // These headers are just handy for writing this example file.  Nothing Skia specific.
 #include <cstdlib>
@@ -33,7 +37,13 @@
 #include <numeric>
 #include <assert.h>
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #include <GLFW/glfw3.h>
 
@@ -44,6 +54,7 @@ static int gHeight = 768;
 
 extern YAML::Node loadYAMLFile(const char *file);
 extern void drawYAMLFile(YAML::Node &doc, SkCanvas *canvas);
+extern void setYAMLItemCounter(blink::CountingCanvas *counter);
 
 double percentile(std::vector<double> &values, int pct_int)
 {
@@ -119,25 +130,287 @@ static void key_callback(GLFWwindow* window, int key, int scancode, int action,
         glfwSetWindowShouldClose(window, GL_TRUE);
 }
 
-void
-dump_to_png(SkPicture *pic, const char *png_name)
+// Plays |pic| back on a raster surface the size of the window, the way a frame is drawn.
+static sk_sp<SkImage>
+render_to_image(SkPicture *pic, double scale)
 {
-    std::shared_ptr<SkSurface> surface = create_raster_surface(gWidth, gHeight);
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(gWidth, gHeight);
     SkCanvas* ic = surface->getCanvas();   // We don't manage this pointer's lifetime.
-    pic->playback(ic);
-
-    sk_sp<SkImage> image = surface->makeImageSnapshot();
-    std::shared_ptr<SkData> png = adopt(image->encode(SkEncodedImageFormat::kPNG, 100));
+    SkMatrix scaleMatrix = SkMatrix::MakeScale(SkDoubleToScalar(scale));
+    ic->clear(SK_ColorWHITE);
+    ic->drawPicture(pic, &scaleMatrix, nullptr);
+    return surface->makeImageSnapshot();
+}
 
+static bool
+write_png(SkImage *image, const std::string &png_name)
+{
+    SkData *encoded = image->encode(SkEncodedImageFormat::kPNG, 100);
+    if (!encoded) {
+        fprintf(stderr, "Could not encode %s\n", png_name.c_str());
+        return false;
+    }
+    std::shared_ptr<SkData> png = adopt(encoded);
     std::ofstream(png_name, std::ios::out | std::ios::binary)
         .write((const char*)png->data(), png->size());
-    std::cout << "Wrote " << png_name << std::endl;
+    return true;
+}
+
+void
+dump_to_png(SkPicture *pic, const char *png_name)
+{
+    sk_sp<SkImage> image = render_to_image(pic, 1.0);
+    if (write_png(image.get(), png_name))
+        std::cout << "Wrote " << png_name << std::endl;
+}
+
+// Writes frames as PNG files on worker threads. add() only queues a reference to the
+// frame's picture; the workers play it back on raster surfaces, then encode and write
+// the result. Nothing is read back from the window surface, so dumping neither stalls
+// the render loop on the GPU nor depends on the back buffer surviving the swap.
+class PngDumpQueue {
+public:
+    PngDumpQueue(unsigned workers, double scale)
+        : m_scale(scale)
+    {
+        for (unsigned i = 0; i < workers; i++)
+            m_workers.emplace_back([this] { run(); });
+    }
+
+    ~PngDumpQueue() { finish(); }
+
+    // Writes the frames still waiting and stops the workers.
+    void finish()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done = true;
+        }
+        m_has_work.notify_all();
+        for (std::thread &worker : m_workers)
+            worker.join();
+        m_workers.clear();
+    }
+
+    void add(sk_sp<SkPicture> pic, std::string png_name)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_frames.push_back({ std::move(pic), std::move(png_name) });
+        }
+        m_has_work.notify_one();
+    }
+
+    unsigned written() const { return m_written; }
+
+private:
+    struct Frame {
+        sk_sp<SkPicture> pic;
+        std::string png_name;
+    };
+
+    void run()
+    {
+        for (;;) {
+            Frame frame;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_has_work.wait(lock, [this] { return m_done || !m_frames.empty(); });
+                if (m_frames.empty())
+                    return;
+                frame = std::move(m_frames.front());
+                m_frames.pop_front();
+            }
+
+            sk_sp<SkImage> image = render_to_image(frame.pic.get(), m_scale);
+            if (image && write_png(image.get(), frame.png_name))
+                m_written++;
+        }
+    }
+
+    const double m_scale;
+    std::mutex m_mutex;
+    std::condition_variable m_has_work;
+    std::deque<Frame> m_frames;
+    std::vector<std::thread> m_workers;
+    std::atomic<unsigned> m_written { 0 };
+    bool m_done = false;
+};
+
+// Records a scene the same way the render loop does.
+static sk_sp<SkPicture>
+record_scene(const char *file)
+{
+    if (strstr(file, ".skp") != nullptr) {
+        SkFILEStream stream(file);
+        return SkPicture::MakeFromStream(&stream);
+    }
+
+    YAML::Node doc = loadYAMLFile(file);
+    SkPictureRecorder recorder;
+    SkCanvas* skp_canvas = recorder.beginRecording(gWidth, gHeight, nullptr, 0);
+    skp_canvas->clear(SK_ColorRED);
+    drawYAMLFile(doc, skp_canvas);
+    return recorder.finishRecordingAsPicture();
+}
+
+static bool
+read_n32_pixels(SkImage *image, std::vector<uint32_t> &pixels)
+{
+    SkImageInfo info = SkImageInfo::MakeN32Premul(image->width(), image->height());
+    pixels.resize(image->width() * image->height());
+    return image->readPixels(SkPixmap(info, pixels.data(), info.minRowBytes()), 0, 0);
+}
+
+static int
+channel_difference(uint32_t a, uint32_t b)
+{
+    int result = 0;
+    for (int shift = 0; shift < 32; shift += 8)
+        result = std::max(result, abs(int((a >> shift) & 0xFF) - int((b >> shift) & 0xFF)));
+    return result;
+}
+
+struct GoldenOptions {
+    const char *dir = nullptr;
+    bool update = false;
+    int tolerance = 2;
+    int max_pixels = 0;
+    double scale = 1.0;
+};
+
+// Renders each scene on a raster surface and compares it with <dir>/<scene>.png, where
+// <scene> is the file name without its extension. A scene fails when more than
+// max_pixels pixels differ by more than tolerance in some channel; its rendering and a
+// diff image (failing pixels red, smaller differences yellow) are then written next to
+// the golden as <scene>-actual.png and <scene>-diff.png. Missing goldens are written
+// instead of compared, and so are all of them with --update.
+static int
+run_golden(const std::vector<const char*> &files, const GoldenOptions &options)
+{
+    int failures = 0;
+    for (const char *file : files) {
+        std::string name(file);
+        size_t slash = name.find_last_of("/\\");
+        if (slash != std::string::npos)
+            name = name.substr(slash + 1);
+        name = name.substr(0, name.find_last_of('.'));
+        std::string prefix = std::string(options.dir) + "/" + name;
+
+        sk_sp<SkPicture> pic = record_scene(file);
+        if (!pic) {
+            printf("%s: could not load %s\n", name.c_str(), file);
+            failures++;
+            continue;
+        }
+        sk_sp<SkImage> actual = render_to_image(pic.get(), options.scale);
+
+        sk_sp<SkData> golden_data = SkData::MakeFromFileName((prefix + ".png").c_str());
+        if (options.update || !golden_data) {
+            if (!write_png(actual.get(), prefix + ".png")) {
+                failures++;
+                continue;
+            }
+            printf("%s: wrote %s.png\n", name.c_str(), prefix.c_str());
+            continue;
+        }
+
+        sk_sp<SkImage> golden = SkImage::MakeFromEncoded(golden_data);
+        if (!golden) {
+            printf("%s: could not decode %s.png\n", name.c_str(), prefix.c_str());
+            failures++;
+            continue;
+        }
+        if (golden->width() != actual->width() || golden->height() != actual->height()) {
+            printf("%s: rendered %dx%d, golden is %dx%d\n", name.c_str(),
+                   actual->width(), actual->height(), golden->width(), golden->height());
+            write_png(actual.get(), prefix + "-actual.png");
+            failures++;
+            continue;
+        }
+
+        std::vector<uint32_t> golden_pixels, actual_pixels;
+        if (!read_n32_pixels(golden.get(), golden_pixels) || !read_n32_pixels(actual.get(), actual_pixels)) {
+            printf("%s: could not read pixels\n", name.c_str());
+            failures++;
+            continue;
+        }
+
+        int bad_pixels = 0;
+        int max_difference = 0;
+        std::vector<uint32_t> diff_pixels(actual_pixels.size());
+        for (size_t i = 0; i < actual_pixels.size(); i++) {
+            int difference = channel_difference(golden_pixels[i], actual_pixels[i]);
+            max_difference = std::max(max_difference, difference);
+            if (difference > options.tolerance) {
+                bad_pixels++;
+                diff_pixels[i] = SK_ColorRED;
+            } else if (difference) {
+                diff_pixels[i] = SK_ColorYELLOW;
+            } else {
+                // A faded copy of the golden, for orientation.
+                diff_pixels[i] = 0xFFC0C0C0 | ((golden_pixels[i] >> 2) & 0x3F3F3F);
+            }
+        }
+
+        if (bad_pixels <= options.max_pixels) {
+            printf("%s: ok\n", name.c_str());
+            continue;
+        }
+
+        printf("%s: %d pixels differ by more than %d (up to %d)\n", name.c_str(),
+               bad_pixels, options.tolerance, max_difference);
+        SkImageInfo info = SkImageInfo::MakeN32Premul(actual->width(), actual->height());
+        sk_sp<SkImage> diff = SkImage::MakeRasterCopy(SkPixmap(info, diff_pixels.data(), info.minRowBytes()));
+        write_png(actual.get(), prefix + "-actual.png");
+        write_png(diff.get(), prefix + "-diff.png");
+        failures++;
+    }
+
+    printf("%zu scenes, %d failed\n", files.size(), failures);
+    return failures ? 1 : 0;
+}
+
+static void
+print_op_counts(const blink::CountingCanvas *counter)
+{
+    if (!counter)
+        return;
+    printf("Canvas calls per display item type (first frame):\n");
+    counter->printTable(stdout);
+}
+
+static void
+print_paint_stats(bool should_print)
+{
+    if (!should_print)
+        return;
+    printf("Border painting (first frame):\n");
+    blink::PaintStats::print(stdout);
+}
+
+static void
+finish_dumps(PngDumpQueue *dumper, const char *dump_dir)
+{
+    if (!dumper)
+        return;
+    dumper->finish();
+    printf("Wrote %u frames to %s\n", dumper->written(), dump_dir);
 }
 
 void
 usage()
 {
-    printf("Usage: viewer [-r] [-l seconds] [-w width] [-h height] [-s scale] file.yaml|file.skp\n");
+    printf("Usage: viewer [-r] [-c] [-b] [-d dir] [-j threads] [-l seconds] [-w width] [-h height] [-s scale] file.yaml|file.skp\n");
+    printf("       viewer --golden dir [--update] [--tolerance n] [--max-pixels n] [-w width] [-h height] [-s scale] file...\n");
+    printf("  -c  count the canvas calls made by each display item type and print them at exit\n");
+    printf("  -b  print how often borders took the fast path, and why not, at exit\n");
+    printf("  -d dir  write every 60th frame to dir/frame-NNNNN.png, encoding on worker threads\n");
+    printf("  -j n    number of encoding threads for -d (default: one per core)\n");
+    printf("  --golden dir     render each file without a window and compare it with dir/<file>.png\n");
+    printf("  --update         write the golden images instead of comparing\n");
+    printf("  --tolerance n    largest per-channel difference that still matches (default 2)\n");
+    printf("  --max-pixels n   number of pixels allowed to differ by more than that (default 0)\n");
     exit(1);
 }
 
@@ -145,7 +418,12 @@ int
 main(int argc, char** argv)
 {
     bool should_rebuild_pic = false;
-    const char *in_file = nullptr;
+    bool should_count_ops = false;
+    bool should_print_paint_stats = false;
+    std::vector<const char*> in_files;
+    GoldenOptions golden;
+    const char *dump_dir = nullptr;
+    unsigned dump_threads = std::max(1u, std::thread::hardware_concurrency());
     const uint32_t frames_between_dumps = 60;
     uint32_t exit_after_seconds = 3;
     double scale = 1.0;
@@ -158,6 +436,16 @@ main(int argc, char** argv)
     while (argv[n]) {
         if (strcmp(argv[n], "-r") == 0) {
             should_rebuild_pic = true;
+        } else if (strcmp(argv[n], "-c") == 0) {
+            should_count_ops = true;
+        } else if (strcmp(argv[n], "-b") == 0) {
+            should_print_paint_stats = true;
+        } else if (strcmp(argv[n], "-d") == 0 && argv[n+1]) {
+            dump_dir = argv[n+1];
+            n++;
+        } else if (strcmp(argv[n], "-j") == 0 && argv[n+1]) {
+            dump_threads = std::max(1, atoi(argv[n+1]));
+            n++;
         } else if (strcmp(argv[n], "-l") == 0) {
             exit_after_seconds = atoi(argv[n+1]);
             n++;
@@ -170,14 +458,34 @@ main(int argc, char** argv)
         } else if (strcmp(argv[n], "-s") == 0) {
             scale = atof(argv[n+1]);
             n++;
-        } else if (!in_file) {
-            in_file = argv[n];
+        } else if (strcmp(argv[n], "--golden") == 0 && argv[n+1]) {
+            golden.dir = argv[n+1];
+            n++;
+        } else if (strcmp(argv[n], "--update") == 0) {
+            golden.update = true;
+        } else if (strcmp(argv[n], "--tolerance") == 0 && argv[n+1]) {
+            golden.tolerance = atoi(argv[n+1]);
+            n++;
+        } else if (strcmp(argv[n], "--max-pixels") == 0 && argv[n+1]) {
+            golden.max_pixels = atoi(argv[n+1]);
+            n++;
+        } else if (argv[n][0] != '-') {
+            in_files.push_back(argv[n]);
         } else {
             usage();
         }
         n++;
     }
 
+    if (golden.dir && !in_files.empty()) {
+        golden.scale = scale;
+        return run_golden(in_files, golden);
+    }
+    if (in_files.size() != 1) {
+        usage();
+    }
+    const char *in_file = in_files[0];
+
     sk_sp<SkPicture> pic;
 
     YAML::Node yaml_doc;
@@ -197,6 +505,15 @@ main(int argc, char** argv)
         yaml_doc = loadYAMLFile(in_file);
     }
 
+    // Sits in front of the picture recorder for the first recording when counting.
+    std::unique_ptr<blink::CountingCanvas> op_counter;
+    if (should_count_ops && pic) {
+        op_counter.reset(new blink::CountingCanvas(gWidth, gHeight));
+        op_counter->beginItem("picture");
+        pic->playback(op_counter.get());
+        op_counter->endItem();
+    }
+
     std::cout << "Rendering..." << std::endl;
 
     GLFWwindow* window;
@@ -277,6 +594,10 @@ main(int argc, char** argv)
     uint32_t frame = 0;
     bool warmed_up = false;
 
+    std::unique_ptr<PngDumpQueue> dumper;
+    if (dump_dir)
+        dumper.reset(new PngDumpQueue(dump_threads, scale));
+
     SkMatrix scaleMatrix = SkMatrix::MakeScale(SkDoubleToScalar(scale));
     glViewport(0, 0, width, height);
 
@@ -288,8 +609,21 @@ main(int argc, char** argv)
 
             skp_canvas->clear(SK_ColorRED);
 
-            drawYAMLFile(yaml_doc, skp_canvas);
+            // Only collect paint stats for the first recording so they describe one frame.
+            blink::PaintStats::setEnabled(should_print_paint_stats && frame == 0);
 
+            if (should_count_ops && !op_counter) {
+                op_counter.reset(new blink::CountingCanvas(gWidth, gHeight));
+                op_counter->addCanvas(skp_canvas);
+                setYAMLItemCounter(op_counter.get());
+                drawYAMLFile(yaml_doc, op_counter.get());
+                setYAMLItemCounter(nullptr);
+                op_counter->removeAll();
+            } else {
+                drawYAMLFile(yaml_doc, skp_canvas);
+            }
+
+            blink::PaintStats::setEnabled(false);
             pic = recorder.finishRecordingAsPicture();
 #if 0
             SkFILEWStream stream("out.skp");
@@ -331,6 +665,12 @@ main(int argc, char** argv)
             min_frame = FpMilliseconds::max();
             max_frame = FpMilliseconds::min();
             sum_frame = FpMilliseconds::zero();
+
+            if (dumper) {
+                char png_name[1024];
+                snprintf(png_name, sizeof(png_name), "%s/frame-%05u.png", dump_dir, frame);
+                dumper->add(pic, png_name);
+            }
         }
 
         //printf("%f\n", FpMilliseconds(after - before).count());
@@ -360,10 +700,16 @@ main(int argc, char** argv)
                        F(val_10th_pct), F(average_ms), F(val_90th_pct));
             }
 
+            print_op_counts(op_counter.get());
+            print_paint_stats(should_print_paint_stats);
+            finish_dumps(dumper.get(), dump_dir);
             exit(0);
         }
     }
 
+    print_op_counts(op_counter.get());
+    print_paint_stats(should_print_paint_stats);
+    finish_dumps(dumper.get(), dump_dir);
     glfwDestroyWindow(window);
     glfwTerminate();
 }
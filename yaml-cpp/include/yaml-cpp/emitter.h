@@ -77,7 +77,24 @@ class YAML_CPP_API Emitter : private noncopyable {
   template <typename T>
   Emitter& WriteStreamable(T value);
 
+  // Writes a whole flow sequence of numbers, like [1, 0.5, -2], straight into
+  // the output instead of formatting each number on its own. Floating point
+  // numbers are written with the fewest digits that read back as the same
+  // value (so the precision settings do not apply), and infinities and NaNs
+  // as .inf, -.inf and .nan.
+  Emitter& WriteFlowSeq(const int* values, std::size_t count);
+  Emitter& WriteFlowSeq(const unsigned int* values, std::size_t count);
+  Emitter& WriteFlowSeq(const long* values, std::size_t count);
+  Emitter& WriteFlowSeq(const unsigned long* values, std::size_t count);
+  Emitter& WriteFlowSeq(const long long* values, std::size_t count);
+  Emitter& WriteFlowSeq(const unsigned long long* values, std::size_t count);
+  Emitter& WriteFlowSeq(const float* values, std::size_t count);
+  Emitter& WriteFlowSeq(const double* values, std::size_t count);
+
  private:
+  template <typename T>
+  Emitter& WriteNumberSeq(const T* values, std::size_t count);
+
   template <typename T>
   void SetStreamablePrecision(std::stringstream&) {}
   std::size_t GetFloatPrecision() const;
@@ -8,10 +8,12 @@
 #endif
 
 #include <array>
+#include <cstddef>
 #include <limits>
 #include <list>
 #include <map>
 #include <sstream>
+#include <type_traits>
 #include <vector>
 
 #include "yaml-cpp/binary.h"
@@ -42,8 +44,44 @@ inline bool IsNegativeInfinity(const std::string& input) {
 inline bool IsNaN(const std::string& input) {
   return input == ".nan" || input == ".NaN" || input == ".NAN";
 }
+
+template <typename T>
+struct is_bulk_number : std::false_type {};
 }
 
+// Bulk numeric decoding
+//
+// DecodeNumbers(node, out) decodes a sequence of numeric scalars, or a single
+// scalar of numbers separated by whitespace ("1 2.5 -3"), into the caller's
+// vector, which is resized to fit. DecodeNumbers(node, out, count) decodes
+// into a buffer and fails unless there are exactly count numbers.
+//
+// Plain decimal numbers are parsed straight from the scalars, independently
+// of the locale and without creating a Node per element; anything else (hex,
+// ".inf", ...) goes through convert<T>. Both return false if the node is not
+// a sequence or a scalar, or if some number does not decode as a T.
+#define YAML_DECLARE_DECODE_NUMBERS(type)                                  \
+  namespace conversion {                                                   \
+  template <>                                                              \
+  struct is_bulk_number<type> : std::true_type {};                         \
+  }                                                                        \
+  YAML_CPP_API bool DecodeNumbers(const Node& node, std::vector<type>& out); \
+  YAML_CPP_API bool DecodeNumbers(const Node& node, type* out,             \
+                                  std::size_t count)
+
+YAML_DECLARE_DECODE_NUMBERS(int);
+YAML_DECLARE_DECODE_NUMBERS(short);
+YAML_DECLARE_DECODE_NUMBERS(long);
+YAML_DECLARE_DECODE_NUMBERS(long long);
+YAML_DECLARE_DECODE_NUMBERS(unsigned);
+YAML_DECLARE_DECODE_NUMBERS(unsigned short);
+YAML_DECLARE_DECODE_NUMBERS(unsigned long);
+YAML_DECLARE_DECODE_NUMBERS(unsigned long long);
+YAML_DECLARE_DECODE_NUMBERS(float);
+YAML_DECLARE_DECODE_NUMBERS(double);
+
+#undef YAML_DECLARE_DECODE_NUMBERS
+
 // Node
 template <>
 struct convert<Node> {
@@ -203,6 +241,11 @@ struct convert<std::vector<T>> {
     if (!node.IsSequence())
       return false;
 
+    // Anything that cannot be decoded in bulk goes element by element, so
+    // that a bad element throws as before.
+    if (decodeNumbers(node, rhs, conversion::is_bulk_number<T>()))
+      return true;
+
     rhs.clear();
     for (const_iterator it = node.begin(); it != node.end(); ++it)
 #if defined(__GNUC__) && __GNUC__ < 4
@@ -213,6 +256,16 @@ struct convert<std::vector<T>> {
 #endif
     return true;
   }
+
+ private:
+  static bool decodeNumbers(const Node& node, std::vector<T>& rhs,
+                            std::true_type) {
+    return DecodeNumbers(node, rhs);
+  }
+  static bool decodeNumbers(const Node& /* node */, std::vector<T>& /* rhs */,
+                            std::false_type) {
+    return false;
+  }
 };
 
 // std::list
@@ -258,6 +311,10 @@ struct convert<std::array<T, N>> {
       return false;
     }
 
+    if (decodeNumbers(node, rhs, conversion::is_bulk_number<T>())) {
+      return true;
+    }
+
     for (auto i = 0u; i < node.size(); ++i) {
 #if defined(__GNUC__) && __GNUC__ < 4
       // workaround for GCC 3:
@@ -273,6 +330,15 @@ struct convert<std::array<T, N>> {
   static bool isNodeValid(const Node& node) {
     return node.IsSequence() && node.size() == N;
   }
+
+  static bool decodeNumbers(const Node& node, std::array<T, N>& rhs,
+                            std::true_type) {
+    return DecodeNumbers(node, rhs.data(), N);
+  }
+  static bool decodeNumbers(const Node& /* node */,
+                            std::array<T, N>& /* rhs */, std::false_type) {
+    return false;
+  }
 };
 
 // std::pair
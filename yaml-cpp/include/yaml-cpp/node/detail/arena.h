@@ -0,0 +1,82 @@
+#ifndef VALUE_DETAIL_ARENA_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define VALUE_DETAIL_ARENA_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+
+namespace YAML {
+namespace detail {
+// A bump allocator. Memory is handed out from chunks that grow as the arena
+// fills up, and is only given back, all at once, when the arena is destroyed.
+class YAML_CPP_API arena {
+ public:
+  arena();
+  ~arena();
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  void* allocate(std::size_t size, std::size_t alignment);
+
+ private:
+  void* allocate_from_new_chunk(std::size_t size, std::size_t alignment);
+
+ private:
+  std::vector<char*> m_chunks;
+  char* m_pos;
+  char* m_end;
+  std::size_t m_nextChunkSize;
+};
+
+inline void* arena::allocate(std::size_t size, std::size_t alignment) {
+  std::size_t misalignment =
+      reinterpret_cast<std::size_t>(m_pos) & (alignment - 1);
+  char* p = m_pos + (misalignment ? alignment - misalignment : 0);
+  if (!m_pos || size > static_cast<std::size_t>(m_end - p))
+    return allocate_from_new_chunk(size, alignment);
+  m_pos = p + size;
+  return p;
+}
+
+// Lets std::allocate_shared place an object and its reference count in an
+// arena. Deallocation does nothing; the arena frees everything at the end.
+template <typename T>
+class arena_allocator {
+ public:
+  typedef T value_type;
+
+  explicit arena_allocator(arena& a) : m_pArena(&a) {}
+  template <typename U>
+  arena_allocator(const arena_allocator<U>& rhs) : m_pArena(rhs.m_pArena) {}
+
+  T* allocate(std::size_t n) {
+    return static_cast<T*>(m_pArena->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T*, std::size_t) {}
+
+  template <typename U>
+  bool operator==(const arena_allocator<U>& rhs) const {
+    return m_pArena == rhs.m_pArena;
+  }
+  template <typename U>
+  bool operator!=(const arena_allocator<U>& rhs) const {
+    return m_pArena != rhs.m_pArena;
+  }
+
+ private:
+  template <typename U>
+  friend class arena_allocator;
+
+  arena* m_pArena;
+};
+}
+}
+
+#endif  // VALUE_DETAIL_ARENA_H_62B23520_7C8E_11DE_8A39_0800200C9A66
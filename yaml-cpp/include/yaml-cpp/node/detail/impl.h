@@ -80,20 +80,14 @@ inline node* node_data::get(const Key& key,
     case NodeType::Null:
       return NULL;
     case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory))
+      if (node* pNode = get_idx<Key>::get(elements().sequence, key, pMemory))
         return pNode;
       return NULL;
     case NodeType::Scalar:
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->equals(key, pMemory)) {
-      return it->second;
-    }
-  }
-
-  return NULL;
+  return find_key(key, pMemory, false);
 }
 
 template <typename Key>
@@ -104,7 +98,7 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
     case NodeType::Undefined:
     case NodeType::Null:
     case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory)) {
+      if (node* pNode = get_idx<Key>::get(elements().sequence, key, pMemory)) {
         m_type = NodeType::Sequence;
         return *pNode;
       }
@@ -115,11 +109,8 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
-    if (it->first->equals(key, pMemory)) {
-      return *it->second;
-    }
-  }
+  if (node* pValue = find_key(key, pMemory, true))
+    return *pValue;
 
   node& k = convert_to_node(key, pMemory);
   node& v = pMemory->create_node();
@@ -132,9 +123,11 @@ inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
   if (m_type != NodeType::Map)
     return false;
 
-  for (node_map::iterator it = m_map.begin(); it != m_map.end(); ++it) {
+  node_map& map = elements().map;
+  for (node_map::iterator it = map.begin(); it != map.end(); ++it) {
     if (it->first->equals(key, pMemory)) {
-      m_map.erase(it);
+      map.erase(it);
+      reset_key_index();
       return true;
     }
   }
@@ -142,6 +135,19 @@ inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
   return false;
 }
 
+template <typename Key>
+inline node* node_data::find_key(const Key& key, shared_memory_holder pMemory,
+                                 bool /* build_index */) const {
+  const node_map& map = elements().map;
+  for (node_map::const_iterator it = map.begin(); it != map.end(); ++it) {
+    if (it->first->equals(key, pMemory)) {
+      return it->second;
+    }
+  }
+
+  return NULL;
+}
+
 // map
 template <typename Key, typename Value>
 inline void node_data::force_insert(const Key& key, const Value& value,
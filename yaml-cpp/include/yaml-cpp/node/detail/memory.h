@@ -7,7 +7,9 @@
 #pragma once
 #endif
 
+#include <memory>
 #include <set>
+#include <vector>
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/ptr.h"
@@ -20,19 +22,43 @@ class node;
 
 namespace YAML {
 namespace detail {
+class arena;
+class arena_set;
+
+// Owns every node of a graph. By default each node is a separate allocation.
+// With use_arena, nodes and their refs and data are bump-allocated from an
+// arena instead and are all freed together with the memory, which is how the
+// parser builds loaded documents.
+//
+// Memories that have been merged share one arena_set, which owns all of their
+// arenas, so a memory never holds a reference to another one. The arenas go
+// when the last memory sharing them does.
 class YAML_CPP_API memory {
  public:
+  explicit memory(bool use_arena = false);
+  ~memory();
+  memory(const memory&) = delete;
+  memory& operator=(const memory&) = delete;
+
   node& create_node();
-  void merge(const memory& rhs);
+  void merge(const shared_memory& rhs);
+
+ private:
+  const std::shared_ptr<arena_set>& arenas();
 
  private:
+  // Declared before m_nodes, so that the heap nodes, which may point into
+  // the arenas, are destroyed first.
+  std::shared_ptr<arena_set> m_pArenas;
+  arena* m_pArena;  // this memory's own arena, owned by m_pArenas
   typedef std::set<shared_node> Nodes;
   Nodes m_nodes;
 };
 
 class YAML_CPP_API memory_holder {
  public:
-  memory_holder() : m_pMemory(new memory) {}
+  explicit memory_holder(bool use_arena = false)
+      : m_pMemory(new memory(use_arena)) {}
 
   node& create_node() { return m_pMemory->create_node(); }
   void merge(memory_holder& rhs);
@@ -11,6 +11,7 @@
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/type.h"
 #include "yaml-cpp/node/ptr.h"
+#include "yaml-cpp/node/detail/arena.h"
 #include "yaml-cpp/node/detail/node_ref.h"
 #include <set>
 
@@ -19,6 +20,8 @@ namespace detail {
 class node {
  public:
   node() : m_pRef(new node_ref) {}
+  explicit node(arena& a)
+      : m_pRef(std::allocate_shared<node_ref>(arena_allocator<node_ref>(a), a)) {}
   node(const node&) = delete;
   node& operator=(const node&) = delete;
 
@@ -32,6 +35,10 @@ class node {
   const std::string& scalar() const { return m_pRef->scalar(); }
   const std::string& tag() const { return m_pRef->tag(); }
   EmitterStyle::value style() const { return m_pRef->style(); }
+  std::size_t scalar_hash() const { return m_pRef->scalar_hash(); }
+  void add_key_index(const std::shared_ptr<node_data::key_index>& index) const {
+    m_pRef->add_key_index(index);
+  }
 
   template <typename T>
   bool equals(const T& rhs, shared_memory_holder pMemory);
@@ -58,6 +65,7 @@ class node {
   void set_ref(const node& rhs) {
     if (rhs.is_defined())
       mark_defined();
+    m_pRef->invalidate_key_indexes();
     m_pRef = rhs.m_pRef;
   }
   void set_data(const node& rhs) {
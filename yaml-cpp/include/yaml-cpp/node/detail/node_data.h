@@ -9,6 +9,7 @@
 
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +31,7 @@ namespace detail {
 class YAML_CPP_API node_data {
  public:
   node_data();
+  ~node_data();
   node_data(const node_data&) = delete;
   node_data& operator=(const node_data&) = delete;
 
@@ -50,6 +52,16 @@ class YAML_CPP_API node_data {
   const std::string& tag() const { return m_tag; }
   EmitterStyle::value style() const { return m_style; }
 
+  // Hash of the scalar, computed on first use and never 0.
+  std::size_t scalar_hash() const;
+
+  // Key index support: a node_data that is the key of an indexed map keeps
+  // a weak reference to the map's index and invalidates it when it changes,
+  // see find_key(). Other maps keep their indexes.
+  struct key_index;
+  void add_key_index(const std::shared_ptr<key_index>& index) const;
+  void invalidate_key_indexes() const;
+
   // size/iterator
   std::size_t size() const;
 
@@ -97,6 +109,31 @@ class YAML_CPP_API node_data {
   template <typename T>
   static node& convert_to_node(const T& rhs, shared_memory_holder pMemory);
 
+  // Finds the value of the first key that equals |key|. String keys of maps
+  // with many entries are looked up in a hash index, which is built on demand
+  // when |build_index| is set and is otherwise only used while still valid.
+  template <typename Key>
+  node* find_key(const Key& key, shared_memory_holder pMemory,
+                 bool build_index) const;
+  node* find_key(const std::string& key, shared_memory_holder pMemory,
+                 bool build_index) const;
+
+  bool key_index_is_current() const;
+  void build_key_index() const;
+  void add_to_key_index(std::size_t position) const;
+  void reset_key_index();
+
+  struct collection;
+  collection& elements() const {
+    if (!m_pCollection)
+      m_pCollection.reset(new collection);
+    return *m_pCollection;
+  }
+  void key_changed() {
+    if (m_pKeyIndexes)
+      invalidate_key_indexes();
+  }
+
  private:
   bool m_isDefined;
   Mark m_mark;
@@ -106,20 +143,31 @@ class YAML_CPP_API node_data {
 
   // scalar
   std::string m_scalar;
+  mutable std::size_t m_scalarHash;
 
-  // sequence
+  // sequence and map
   typedef std::vector<node*> node_seq;
-  node_seq m_sequence;
-
-  mutable std::size_t m_seqSize;
-
-  // map
   typedef std::vector<std::pair<node*, node*>> node_map;
-  node_map m_map;
-
   typedef std::pair<node*, node*> kv_pair;
   typedef std::list<kv_pair> kv_pairs;
-  mutable kv_pairs m_undefinedPairs;
+
+  // Most nodes are scalars, so this is only allocated for nodes that are used
+  // as a sequence or a map.
+  struct collection {
+    collection() : seqSize(0) {}
+
+    node_seq sequence;
+    std::size_t seqSize;
+
+    node_map map;
+    kv_pairs undefinedPairs;
+  };
+  mutable std::unique_ptr<collection> m_pCollection;
+
+  // The index of this map's keys, and the indexes of the maps that this node
+  // is a key of. Only nodes that are part of an index allocate the latter.
+  mutable std::shared_ptr<key_index> m_pKeyIndex;
+  mutable std::unique_ptr<std::vector<std::weak_ptr<key_index>>> m_pKeyIndexes;
 };
 }
 }
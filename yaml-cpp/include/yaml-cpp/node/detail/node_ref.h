@@ -10,6 +10,7 @@
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/type.h"
 #include "yaml-cpp/node/ptr.h"
+#include "yaml-cpp/node/detail/arena.h"
 #include "yaml-cpp/node/detail/node_data.h"
 
 namespace YAML {
@@ -17,6 +18,8 @@ namespace detail {
 class node_ref {
  public:
   node_ref() : m_pData(new node_data) {}
+  explicit node_ref(arena& a)
+      : m_pData(std::allocate_shared<node_data>(arena_allocator<node_data>(a))) {}
   node_ref(const node_ref&) = delete;
   node_ref& operator=(const node_ref&) = delete;
 
@@ -26,9 +29,17 @@ class node_ref {
   const std::string& scalar() const { return m_pData->scalar(); }
   const std::string& tag() const { return m_pData->tag(); }
   EmitterStyle::value style() const { return m_pData->style(); }
+  std::size_t scalar_hash() const { return m_pData->scalar_hash(); }
+  void add_key_index(const std::shared_ptr<node_data::key_index>& index) const {
+    m_pData->add_key_index(index);
+  }
+  void invalidate_key_indexes() const { m_pData->invalidate_key_indexes(); }
 
   void mark_defined() { m_pData->mark_defined(); }
-  void set_data(const node_ref& rhs) { m_pData = rhs.m_pData; }
+  void set_data(const node_ref& rhs) {
+    m_pData->invalidate_key_indexes();
+    m_pData = rhs.m_pData;
+  }
 
   void set_mark(const Mark& mark) { m_pData->set_mark(mark); }
   void set_type(NodeType::value type) { m_pData->set_type(type); }
@@ -22,6 +22,7 @@ namespace detail {
 class node;
 class node_data;
 struct iterator_value;
+struct number_decoder;
 }  // namespace detail
 }  // namespace YAML
 
@@ -33,6 +34,7 @@ class YAML_CPP_API Node {
   friend struct detail::iterator_value;
   friend class detail::node;
   friend class detail::node_data;
+  friend struct detail::number_decoder;
   template <typename>
   friend class detail::iterator_base;
   template <typename T, typename S>
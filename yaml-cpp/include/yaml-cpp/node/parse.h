@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -73,6 +74,31 @@ YAML_CPP_API std::vector<Node> LoadAll(std::istream& input);
  * @throws {@link BadFile} if the file cannot be loaded.
  */
 YAML_CPP_API std::vector<Node> LoadAllFromFile(const std::string& filename);
+
+/**
+ * Loads the input string as a list of YAML documents, like {@link LoadAll},
+ * but on up to {@param threads} threads (0 means one per hardware thread).
+ * The input is split before every line that starts with a "---" document
+ * marker, and the pieces are parsed at the same time, each document into
+ * its own memory. The documents are returned in order.
+ *
+ * Input that is not UTF-8 or that has directives is loaded serially, and so
+ * is malformed input, again, to throw the same error as {@link LoadAll}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API std::vector<Node> LoadAllParallel(const std::string& input,
+                                               std::size_t threads = 0);
+
+/**
+ * Loads the input file as a list of YAML documents, like
+ * {@link LoadAllParallel}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadFile} if the file cannot be loaded.
+ */
+YAML_CPP_API std::vector<Node> LoadAllFromFileParallel(
+    const std::string& filename, std::size_t threads = 0);
 }  // namespace YAML
 
 #endif  // VALUE_PARSE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -7,10 +7,12 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <ios>
 #include <memory>
 
 #include "yaml-cpp/dll.h"
+#include "yaml-cpp/mark.h"
 #include "yaml-cpp/noncopyable.h"
 
 namespace YAML {
@@ -35,6 +37,13 @@ class YAML_CPP_API Parser : private noncopyable {
    */
   explicit Parser(std::istream& in);
 
+  /**
+   * Constructs a parser that reads {@param size} bytes straight out of
+   * {@param data}, without going through a stream. The buffer must live as
+   * long as the parser.
+   */
+  Parser(const char* data, std::size_t size);
+
   ~Parser();
 
   /** Evaluates to true if the parser has some valid input to be read. */
@@ -46,6 +55,13 @@ class YAML_CPP_API Parser : private noncopyable {
    */
   void Load(std::istream& in);
 
+  /**
+   * Resets the parser with the given buffer. Any existing state is erased.
+   * Marks are counted from {@param start}, so that a buffer that is a piece
+   * of a larger input reports positions in that input.
+   */
+  void Load(const char* data, std::size_t size, const Mark& start = Mark());
+
   /**
    * Handles the next document by calling events on the {@param eventHandler}.
    *
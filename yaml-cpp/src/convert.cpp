@@ -1,6 +1,8 @@
 #include <algorithm>
+#include <cfloat>
 
 #include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/node.h"
 
 namespace {
 // we're not gonna mess with the mess that is all the isupper/etc. functions
@@ -39,9 +41,258 @@ bool IsFlexibleCase(const std::string& str) {
   std::string rest = str.substr(1);
   return firstcaps && (IsEntirely(rest, IsLower) || IsEntirely(rest, IsUpper));
 }
+
+bool IsDigit(char ch) { return '0' <= ch && ch <= '9'; }
+
+bool IsNumberSeparator(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+// ParseNumber
+// . Parses the plain decimal forms that almost all numbers take, exactly and
+//   without a locale. Returns false for anything else (leading zeros, which
+//   the stream reads as octal or hex, special values, whitespace, too many
+//   digits, overflow); convert<T> has the final say on those.
+template <typename T>
+bool ParseNumber(const char* p, const char* end, T& value,
+                 typename std::enable_if<std::is_integral<T>::value>::type* =
+                     0) {
+  bool negative = false;
+  if (p != end && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    p++;
+  }
+  if (p == end || (negative && !std::numeric_limits<T>::is_signed))
+    return false;
+  if (*p == '0' && end - p > 1)
+    return false;
+
+  const unsigned long long limit =
+      negative ? 0ULL - static_cast<unsigned long long>(
+                            std::numeric_limits<T>::min())
+               : static_cast<unsigned long long>(std::numeric_limits<T>::max());
+  unsigned long long magnitude = 0;
+  for (; p != end; p++) {
+    if (!IsDigit(*p))
+      return false;
+    unsigned digit = static_cast<unsigned>(*p - '0');
+    if (magnitude > (limit - digit) / 10)
+      return false;
+    magnitude = magnitude * 10 + digit;
+  }
+
+  if (negative && magnitude > 0)
+    value = static_cast<T>(-static_cast<T>(magnitude - 1) - 1);
+  else
+    value = static_cast<T>(magnitude);
+  return true;
+}
+
+// For floating point, the digits are gathered into an integer that the type
+// holds exactly and scaled by a power of ten that it also holds exactly; one
+// correctly rounded multiplication or division then gives the correctly
+// rounded result (Clinger's fast path). This needs arithmetic in the type's
+// own precision, which excess-precision targets such as x87 do not give.
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+const bool kExactFloatArithmetic = true;
+#else
+const bool kExactFloatArithmetic = false;
+#endif
+
+template <typename T>
+struct exact_float;
+
+template <>
+struct exact_float<float> {
+  static const unsigned long long max_digits = 1ULL << 24;
+  static const int max_exponent = 10;
+};
+
+template <>
+struct exact_float<double> {
+  static const unsigned long long max_digits = 1ULL << 53;
+  static const int max_exponent = 22;
+};
+
+template <typename T>
+bool ParseNumber(const char* p, const char* end, T& value,
+                 typename std::enable_if<
+                     std::is_floating_point<T>::value>::type* = 0) {
+  if (!kExactFloatArithmetic)
+    return false;
+
+  static const double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                  1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                  1e18, 1e19, 1e20, 1e21, 1e22};
+
+  bool negative = false;
+  if (p != end && (*p == '+' || *p == '-')) {
+    negative = *p == '-';
+    p++;
+  }
+
+  unsigned long long digits = 0;
+  int exponent = 0;
+  bool sawDigit = false;
+  for (; p != end && IsDigit(*p); p++) {
+    digits = digits * 10 + static_cast<unsigned>(*p - '0');
+    if (digits > exact_float<T>::max_digits)
+      return false;
+    sawDigit = true;
+  }
+  if (p != end && *p == '.') {
+    for (p++; p != end && IsDigit(*p); p++) {
+      digits = digits * 10 + static_cast<unsigned>(*p - '0');
+      if (digits > exact_float<T>::max_digits)
+        return false;
+      exponent--;
+      sawDigit = true;
+    }
+  }
+  if (!sawDigit)
+    return false;
+
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    p++;
+    bool negativeExponent = false;
+    if (p != end && (*p == '+' || *p == '-')) {
+      negativeExponent = *p == '-';
+      p++;
+    }
+    if (p == end)
+      return false;
+    int written = 0;
+    for (; p != end; p++) {
+      if (!IsDigit(*p) || written > 1000)
+        return false;
+      written = written * 10 + (*p - '0');
+    }
+    exponent += negativeExponent ? -written : written;
+  }
+  if (p != end)
+    return false;
+  if (exponent < -exact_float<T>::max_exponent ||
+      exponent > exact_float<T>::max_exponent)
+    return false;
+
+  T result = static_cast<T>(digits);
+  if (exponent < 0)
+    result /= static_cast<T>(powers[-exponent]);
+  else
+    result *= static_cast<T>(powers[exponent]);
+  value = negative ? -result : result;
+  return true;
+}
+
+template <typename T>
+bool DecodeNumber(const char* begin, const char* end, T& value) {
+  if (ParseNumber(begin, end, value))
+    return true;
+  return YAML::convert<T>::decode(YAML::Node(std::string(begin, end)), value);
+}
+
+template <typename T>
+class VectorSink {
+ public:
+  explicit VectorSink(std::vector<T>& out) : m_out(out) { m_out.clear(); }
+
+  bool add(const char* begin, const char* end) {
+    T value;
+    if (!DecodeNumber(begin, end, value))
+      return false;
+    m_out.push_back(value);
+    return true;
+  }
+  bool finish() const { return true; }
+
+ private:
+  std::vector<T>& m_out;
+};
+
+template <typename T>
+class BufferSink {
+ public:
+  BufferSink(T* out, std::size_t count) : m_out(out), m_count(count), m_n(0) {}
+
+  bool add(const char* begin, const char* end) {
+    return m_n < m_count && DecodeNumber(begin, end, m_out[m_n++]);
+  }
+  bool finish() const { return m_n == m_count; }
+
+ private:
+  T* m_out;
+  std::size_t m_count;
+  std::size_t m_n;
+};
 }
 
 namespace YAML {
+namespace detail {
+struct number_decoder {
+  template <typename Sink>
+  static bool decode(const Node& node, Sink& sink) {
+    switch (node.Type()) {
+      case NodeType::Scalar: {
+        const std::string& scalar = node.Scalar();
+        const char* p = scalar.data();
+        const char* end = p + scalar.size();
+        while (true) {
+          while (p != end && IsNumberSeparator(*p))
+            p++;
+          if (p == end)
+            break;
+          const char* begin = p;
+          while (p != end && !IsNumberSeparator(*p))
+            p++;
+          if (!sink.add(begin, p))
+            return false;
+        }
+        break;
+      }
+      case NodeType::Sequence:
+        for (const_node_iterator it = node.m_pNode->begin();
+             it != node.m_pNode->end(); ++it) {
+          const detail::node& element = **it;
+          if (element.type() != NodeType::Scalar)
+            return false;
+          const std::string& scalar = element.scalar();
+          if (!sink.add(scalar.data(), scalar.data() + scalar.size()))
+            return false;
+        }
+        break;
+      default:
+        return false;
+    }
+    return sink.finish();
+  }
+};
+}
+
+#define YAML_DEFINE_DECODE_NUMBERS(type)                                  \
+  bool DecodeNumbers(const Node& node, std::vector<type>& out) {          \
+    VectorSink<type> sink(out);                                           \
+    return detail::number_decoder::decode(node, sink);                    \
+  }                                                                       \
+                                                                          \
+  bool DecodeNumbers(const Node& node, type* out, std::size_t count) {    \
+    BufferSink<type> sink(out, count);                                    \
+    return detail::number_decoder::decode(node, sink);                    \
+  }
+
+YAML_DEFINE_DECODE_NUMBERS(int)
+YAML_DEFINE_DECODE_NUMBERS(short)
+YAML_DEFINE_DECODE_NUMBERS(long)
+YAML_DEFINE_DECODE_NUMBERS(long long)
+YAML_DEFINE_DECODE_NUMBERS(unsigned)
+YAML_DEFINE_DECODE_NUMBERS(unsigned short)
+YAML_DEFINE_DECODE_NUMBERS(unsigned long)
+YAML_DEFINE_DECODE_NUMBERS(unsigned long long)
+YAML_DEFINE_DECODE_NUMBERS(float)
+YAML_DEFINE_DECODE_NUMBERS(double)
+
+#undef YAML_DEFINE_DECODE_NUMBERS
+
 bool convert<bool>::decode(const Node& node, bool& rhs) {
   if (!node.IsScalar())
     return false;
@@ -1,6 +1,10 @@
+#include <cstring>
+#include <limits>
 #include <sstream>
+#include <type_traits>
 
 #include "emitterutils.h"
+#include "fptostring.h"
 #include "indentation.h"  // IWYU pragma: keep
 #include "yaml-cpp/emitter.h"
 #include "yaml-cpp/emitterdef.h"
@@ -11,6 +15,37 @@ namespace YAML {
 class Binary;
 struct _Null;
 
+namespace {
+template <typename T>
+std::size_t FormatNumber(T value, char* buffer) {
+  // the digits, backwards, of the magnitude (negated in unsigned arithmetic)
+  typedef typename std::make_unsigned<T>::type U;
+  const bool negative = value < 0;
+  U magnitude = negative ? U(0) - static_cast<U>(value) : static_cast<U>(value);
+  char digits[std::numeric_limits<U>::digits10 + 1];
+  char* end = digits + sizeof(digits);
+  char* p = end;
+  do {
+    *--p = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+
+  char* out = buffer;
+  if (negative)
+    *out++ = '-';
+  std::memcpy(out, p, end - p);
+  return (out - buffer) + (end - p);
+}
+
+std::size_t FormatNumber(float value, char* buffer) {
+  return FpToString(value, buffer);
+}
+
+std::size_t FormatNumber(double value, char* buffer) {
+  return FpToString(value, buffer);
+}
+}
+
 Emitter::Emitter() : m_pState(new EmitterState) {}
 
 Emitter::Emitter(std::ostream& stream)
@@ -908,4 +943,69 @@ Emitter& Emitter::Write(const Binary& binary) {
 
   return *this;
 }
+
+// WriteFlowSeq
+Emitter& Emitter::WriteFlowSeq(const int* values, std::size_t count) {
+  return WriteNumberSeq(values, count);
+}
+
+Emitter& Emitter::WriteFlowSeq(const unsigned int* values, std::size_t count) {
+  return WriteNumberSeq(values, count);
+}
+
+Emitter& Emitter::WriteFlowSeq(const long* values, std::size_t count) {
+  return WriteNumberSeq(values, count);
+}
+
+Emitter& Emitter::WriteFlowSeq(const unsigned long* values,
+                               std::size_t count) {
+  return WriteNumberSeq(values, count);
+}
+
+Emitter& Emitter::WriteFlowSeq(const long long* values, std::size_t count) {
+  return WriteNumberSeq(values, count);
+}
+
+Emitter& Emitter::WriteFlowSeq(const unsigned long long* values,
+                               std::size_t count) {
+  return WriteNumberSeq(values, count);
+}
+
+Emitter& Emitter::WriteFlowSeq(const float* values, std::size_t count) {
+  return WriteNumberSeq(values, count);
+}
+
+Emitter& Emitter::WriteFlowSeq(const double* values, std::size_t count) {
+  return WriteNumberSeq(values, count);
+}
+
+template <typename T>
+Emitter& Emitter::WriteNumberSeq(const T* values, std::size_t count) {
+  if (!good())
+    return *this;
+
+  SetLocalValue(Flow);
+  EmitBeginSeq();
+  if (!good())
+    return *this;
+
+  if (std::numeric_limits<T>::is_integer && m_pState->GetIntFormat() != Dec) {
+    for (std::size_t i = 0; i < count; i++)
+      WriteIntegralType(values[i]);
+  } else if (count > 0) {
+    // only the first number needs the usual preparation; after it, each
+    // number is just ", " and its digits
+    char buffer[2 + kMaxFpStringSize] = {',', ' '};
+    PrepareNode(EmitterNodeType::Scalar);
+    m_stream.write(buffer + 2, FormatNumber(values[0], buffer + 2));
+    StartedScalar();
+    for (std::size_t i = 1; i < count; i++) {
+      m_stream.write(buffer, 2 + FormatNumber(values[i], buffer + 2));
+      StartedScalar();
+    }
+  }
+
+  EmitEndSeq();
+  return *this;
+}
 }
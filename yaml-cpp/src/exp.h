@@ -186,6 +186,14 @@ inline const RegEx& EscBreak() {
   static const RegEx e = RegEx('\\') + Break();
   return e;
 }
+inline const RegEx& EndSingleQuotedScalar() {
+  static const RegEx e = RegEx('\'') && !EscSingleQuote();
+  return e;
+}
+inline const RegEx& EndDoubleQuotedScalar() {
+  static const RegEx e = RegEx('\"');
+  return e;
+}
 
 inline const RegEx& ChompIndicator() {
   static const RegEx e = RegEx("+-", REGEX_OR);
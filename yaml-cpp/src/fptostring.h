@@ -0,0 +1,24 @@
+#ifndef FPTOSTRING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define FPTOSTRING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+
+namespace YAML {
+// The most characters FpToString writes.
+const std::size_t kMaxFpStringSize = 32;
+
+// Writes 'value' to 'buffer' with the fewest digits that read back as the
+// same value, independently of the locale, and returns the number of
+// characters written; 'buffer' is not null terminated. Infinities and NaNs
+// are written as .inf, -.inf and .nan.
+std::size_t FpToString(double value, char* buffer);
+std::size_t FpToString(float value, char* buffer);
+}
+
+#endif  // FPTOSTRING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -1,26 +1,133 @@
 #include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/detail/arena.h"
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
 #include "yaml-cpp/node/ptr.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
 namespace YAML {
 namespace detail {
 
+arena::arena() : m_pos(0), m_end(0), m_nextChunkSize(4096) {}
+
+arena::~arena() {
+  for (std::size_t i = 0; i < m_chunks.size(); i++)
+    std::free(m_chunks[i]);
+}
+
+void* arena::allocate_from_new_chunk(std::size_t size, std::size_t alignment) {
+  // Chunks double up to 1MB, so that small graphs stay small and large ones
+  // need few chunks.
+  std::size_t chunkSize = m_nextChunkSize;
+  if (m_nextChunkSize < 1024 * 1024)
+    m_nextChunkSize *= 2;
+  if (chunkSize < size + alignment)
+    chunkSize = size + alignment;
+
+  char* chunk = static_cast<char*>(std::malloc(chunkSize));
+  if (!chunk)
+    throw std::bad_alloc();
+  m_chunks.push_back(chunk);
+  m_pos = chunk;
+  m_end = chunk + chunkSize;
+  return allocate(size, alignment);
+}
+
+// The arenas of a group of merged memories, and the nodes placed in them.
+class arena_set {
+ public:
+  ~arena_set() {
+    // Nodes in one arena may hold the last reference to refs and data in
+    // another, so every node goes before any arena does.
+    for (std::size_t i = 0; i < m_nodes.size(); i++)
+      m_nodes[i]->~node();
+  }
+
+  // Takes over the arenas, nodes and memories of 'rhs', leaving it empty.
+  void absorb(arena_set& rhs) {
+    for (std::size_t i = 0; i < rhs.m_arenas.size(); i++)
+      m_arenas.push_back(std::move(rhs.m_arenas[i]));
+    m_nodes.insert(m_nodes.end(), rhs.m_nodes.begin(), rhs.m_nodes.end());
+    m_memories.insert(m_memories.end(), rhs.m_memories.begin(),
+                      rhs.m_memories.end());
+    rhs.m_arenas.clear();
+    rhs.m_nodes.clear();
+    rhs.m_memories.clear();
+  }
+
+  std::vector<std::unique_ptr<arena>> m_arenas;
+  std::vector<node*> m_nodes;
+  std::vector<memory*> m_memories;  // the memories sharing this set
+};
+
 void memory_holder::merge(memory_holder& rhs) {
   if (m_pMemory == rhs.m_pMemory)
     return;
 
-  m_pMemory->merge(*rhs.m_pMemory);
+  m_pMemory->merge(rhs.m_pMemory);
   rhs.m_pMemory = m_pMemory;
 }
 
+memory::memory(bool use_arena) : m_pArena(0) {
+  if (use_arena) {
+    std::unique_ptr<arena> pArena(new arena);
+    m_pArena = pArena.get();
+    arenas()->m_arenas.push_back(std::move(pArena));
+  }
+}
+
+memory::~memory() {
+  if (m_pArenas) {
+    std::vector<memory*>& memories = m_pArenas->m_memories;
+    memories.erase(std::find(memories.begin(), memories.end(), this));
+  }
+}
+
+const std::shared_ptr<arena_set>& memory::arenas() {
+  if (!m_pArenas) {
+    m_pArenas = std::make_shared<arena_set>();
+    m_pArenas->m_memories.push_back(this);
+  }
+  return m_pArenas;
+}
+
 node& memory::create_node() {
+  if (m_pArena) {
+    void* p = m_pArena->allocate(sizeof(node), alignof(node));
+    node* pNode = new (p) node(*m_pArena);
+    m_pArenas->m_nodes.push_back(pNode);
+    return *pNode;
+  }
+
   shared_node pNode(new node);
   m_nodes.insert(pNode);
   return *pNode;
 }
 
-void memory::merge(const memory& rhs) {
-  m_nodes.insert(rhs.m_nodes.begin(), rhs.m_nodes.end());
+void memory::merge(const shared_memory& rhs) {
+  if (rhs.get() == this)
+    return;
+
+  m_nodes.insert(rhs->m_nodes.begin(), rhs->m_nodes.end());
+  if (!rhs->m_pArenas)
+    return;
+
+  // Both memories now keep all of the arenas alive; the smaller set is
+  // folded into the larger one.
+  std::shared_ptr<arena_set> to = arenas();
+  std::shared_ptr<arena_set> from = rhs->m_pArenas;
+  if (to == from)
+    return;
+  if (to->m_memories.size() < from->m_memories.size())
+    std::swap(to, from);
+
+  std::vector<memory*> moved = from->m_memories;
+  to->absorb(*from);
+  for (std::size_t i = 0; i < moved.size(); i++)
+    moved[i]->m_pArenas = to;
 }
 }
 }
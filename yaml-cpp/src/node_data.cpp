@@ -13,6 +13,35 @@
 namespace YAML {
 namespace detail {
 
+namespace {
+// Maps with fewer entries than this are searched linearly.
+const std::size_t kMinIndexedMapSize = 8;
+
+// FNV-1a, adjusted so that 0 can mean "not computed yet".
+std::size_t hash_scalar(const std::string& scalar) {
+  std::size_t hash = static_cast<std::size_t>(14695981039346656037ULL);
+  for (std::size_t i = 0; i < scalar.size(); i++) {
+    hash ^= static_cast<unsigned char>(scalar[i]);
+    hash *= static_cast<std::size_t>(1099511628211ULL);
+  }
+  return hash ? hash : 1;
+}
+
+bool is_scalar_key(const node& key, const std::string& scalar) {
+  return key.type() == NodeType::Scalar && key.scalar() == scalar;
+}
+}
+
+// Open addressing with linear probing. Slots hold the key's hash and its
+// position in the map plus one, so that 0 marks an empty slot. Keys are added in
+// map order and never removed, so the first match along a probe sequence is
+// the first matching key in the map.
+struct node_data::key_index {
+  bool valid;
+  std::size_t count;
+  std::vector<std::pair<std::size_t, std::size_t>> slots;
+};
+
 std::string node_data::empty_scalar;
 
 node_data::node_data()
@@ -20,9 +49,13 @@ node_data::node_data()
       m_mark(Mark::null_mark()),
       m_type(NodeType::Null),
       m_style(EmitterStyle::Default),
-      m_seqSize(0) {}
+      m_scalarHash(0) {}
+
+node_data::~node_data() {}
 
 void node_data::mark_defined() {
+  if (m_type == NodeType::Undefined || !m_isDefined)
+    key_changed();
   if (m_type == NodeType::Undefined)
     m_type = NodeType::Null;
   m_isDefined = true;
@@ -31,6 +64,7 @@ void node_data::mark_defined() {
 void node_data::set_mark(const Mark& mark) { m_mark = mark; }
 
 void node_data::set_type(NodeType::value type) {
+  key_changed();
   if (type == NodeType::Undefined) {
     m_type = type;
     m_isDefined = false;
@@ -48,6 +82,7 @@ void node_data::set_type(NodeType::value type) {
       break;
     case NodeType::Scalar:
       m_scalar.clear();
+      m_scalarHash = 0;
       break;
     case NodeType::Sequence:
       reset_sequence();
@@ -66,14 +101,23 @@ void node_data::set_tag(const std::string& tag) { m_tag = tag; }
 void node_data::set_style(EmitterStyle::value style) { m_style = style; }
 
 void node_data::set_null() {
+  key_changed();
   m_isDefined = true;
   m_type = NodeType::Null;
 }
 
 void node_data::set_scalar(const std::string& scalar) {
+  key_changed();
   m_isDefined = true;
   m_type = NodeType::Scalar;
   m_scalar = scalar;
+  m_scalarHash = 0;
+}
+
+std::size_t node_data::scalar_hash() const {
+  if (!m_scalarHash)
+    m_scalarHash = hash_scalar(m_scalar);
+  return m_scalarHash;
 }
 
 // size/iterator
@@ -84,10 +128,10 @@ std::size_t node_data::size() const {
   switch (m_type) {
     case NodeType::Sequence:
       compute_seq_size();
-      return m_seqSize;
+      return elements().seqSize;
     case NodeType::Map:
       compute_map_size();
-      return m_map.size() - m_undefinedPairs.size();
+      return elements().map.size() - elements().undefinedPairs.size();
     default:
       return 0;
   }
@@ -95,16 +139,18 @@ std::size_t node_data::size() const {
 }
 
 void node_data::compute_seq_size() const {
-  while (m_seqSize < m_sequence.size() && m_sequence[m_seqSize]->is_defined())
-    m_seqSize++;
+  collection& c = elements();
+  while (c.seqSize < c.sequence.size() && c.sequence[c.seqSize]->is_defined())
+    c.seqSize++;
 }
 
 void node_data::compute_map_size() const {
-  kv_pairs::iterator it = m_undefinedPairs.begin();
-  while (it != m_undefinedPairs.end()) {
+  kv_pairs& undefinedPairs = elements().undefinedPairs;
+  kv_pairs::iterator it = undefinedPairs.begin();
+  while (it != undefinedPairs.end()) {
     kv_pairs::iterator jt = std::next(it);
     if (it->first->is_defined() && it->second->is_defined())
-      m_undefinedPairs.erase(it);
+      undefinedPairs.erase(it);
     it = jt;
   }
 }
@@ -115,9 +161,9 @@ const_node_iterator node_data::begin() const {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.begin());
+      return const_node_iterator(elements().sequence.begin());
     case NodeType::Map:
-      return const_node_iterator(m_map.begin(), m_map.end());
+      return const_node_iterator(elements().map.begin(), elements().map.end());
     default:
       return const_node_iterator();
   }
@@ -129,9 +175,9 @@ node_iterator node_data::begin() {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.begin());
+      return node_iterator(elements().sequence.begin());
     case NodeType::Map:
-      return node_iterator(m_map.begin(), m_map.end());
+      return node_iterator(elements().map.begin(), elements().map.end());
     default:
       return node_iterator();
   }
@@ -143,9 +189,9 @@ const_node_iterator node_data::end() const {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.end());
+      return const_node_iterator(elements().sequence.end());
     case NodeType::Map:
-      return const_node_iterator(m_map.end(), m_map.end());
+      return const_node_iterator(elements().map.end(), elements().map.end());
     default:
       return const_node_iterator();
   }
@@ -157,9 +203,9 @@ node_iterator node_data::end() {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.end());
+      return node_iterator(elements().sequence.end());
     case NodeType::Map:
-      return node_iterator(m_map.end(), m_map.end());
+      return node_iterator(elements().map.end(), elements().map.end());
     default:
       return node_iterator();
   }
@@ -175,7 +221,7 @@ void node_data::push_back(node& node, shared_memory_holder /* pMemory */) {
   if (m_type != NodeType::Sequence)
     throw BadPushback();
 
-  m_sequence.push_back(&node);
+  elements().sequence.push_back(&node);
 }
 
 void node_data::insert(node& key, node& value, shared_memory_holder pMemory) {
@@ -200,7 +246,8 @@ node* node_data::get(node& key, shared_memory_holder /* pMemory */) const {
     return NULL;
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
+  const node_map& map = elements().map;
+  for (node_map::const_iterator it = map.begin(); it != map.end(); ++it) {
     if (it->first->is(key))
       return it->second;
   }
@@ -221,7 +268,8 @@ node& node_data::get(node& key, shared_memory_holder pMemory) {
       throw BadSubscript();
   }
 
-  for (node_map::const_iterator it = m_map.begin(); it != m_map.end(); ++it) {
+  const node_map& map = elements().map;
+  for (node_map::const_iterator it = map.begin(); it != map.end(); ++it) {
     if (it->first->is(key))
       return *it->second;
   }
@@ -235,9 +283,11 @@ bool node_data::remove(node& key, shared_memory_holder /* pMemory */) {
   if (m_type != NodeType::Map)
     return false;
 
-  for (node_map::iterator it = m_map.begin(); it != m_map.end(); ++it) {
+  node_map& map = elements().map;
+  for (node_map::iterator it = map.begin(); it != map.end(); ++it) {
     if (it->first->is(key)) {
-      m_map.erase(it);
+      map.erase(it);
+      reset_key_index();
       return true;
     }
   }
@@ -245,21 +295,135 @@ bool node_data::remove(node& key, shared_memory_holder /* pMemory */) {
   return false;
 }
 
+node* node_data::find_key(const std::string& key,
+                          shared_memory_holder /* pMemory */,
+                          bool build_index) const {
+  const node_map& map = elements().map;
+  if (map.size() >= kMinIndexedMapSize) {
+    bool valid = key_index_is_current();
+    if (!valid && build_index) {
+      build_key_index();
+      valid = true;
+    }
+    if (valid) {
+      std::size_t hash = hash_scalar(key);
+      std::size_t mask = m_pKeyIndex->slots.size() - 1;
+      for (std::size_t i = hash & mask; m_pKeyIndex->slots[i].second;
+           i = (i + 1) & mask) {
+        if (m_pKeyIndex->slots[i].first != hash)
+          continue;
+        const kv_pair& pair = map[m_pKeyIndex->slots[i].second - 1];
+        if (is_scalar_key(*pair.first, key))
+          return pair.second;
+      }
+      return NULL;
+    }
+  }
+
+  for (node_map::const_iterator it = map.begin(); it != map.end(); ++it) {
+    if (is_scalar_key(*it->first, key))
+      return it->second;
+  }
+  return NULL;
+}
+
+bool node_data::key_index_is_current() const {
+  return m_pKeyIndex && m_pKeyIndex->valid;
+}
+
+void node_data::build_key_index() const {
+  // Not make_shared: the weak references held by the keys would keep the
+  // whole index allocated, not just the control block.
+  if (!m_pKeyIndex)
+    m_pKeyIndex.reset(new key_index);
+
+  std::size_t size = elements().map.size();
+  std::size_t capacity = 16;
+  while (capacity < 2 * size)
+    capacity *= 2;
+  m_pKeyIndex->valid = true;
+  m_pKeyIndex->count = 0;
+  m_pKeyIndex->slots.assign(capacity, std::make_pair(0, 0));
+  for (std::size_t i = 0; i < size; i++)
+    add_to_key_index(i);
+}
+
+void node_data::add_to_key_index(std::size_t position) const {
+  const node& key = *elements().map[position].first;
+  // Keys that are not scalars yet are tracked too, so that they invalidate
+  // the index when they become one.
+  key.add_key_index(m_pKeyIndex);
+  if (key.type() != NodeType::Scalar)
+    return;
+
+  std::size_t hash = key.scalar_hash();
+  std::size_t mask = m_pKeyIndex->slots.size() - 1;
+  std::size_t i = hash & mask;
+  while (m_pKeyIndex->slots[i].second)
+    i = (i + 1) & mask;
+  m_pKeyIndex->slots[i] = std::make_pair(hash, position + 1);
+  m_pKeyIndex->count++;
+}
+
+void node_data::reset_key_index() { m_pKeyIndex.reset(); }
+
+void node_data::add_key_index(const std::shared_ptr<key_index>& index) const {
+  if (!m_pKeyIndexes)
+    m_pKeyIndexes.reset(new std::vector<std::weak_ptr<key_index>>);
+
+  // A key is in few maps, and rebuilding an index adds its keys again.
+  std::vector<std::weak_ptr<key_index>>& indexes = *m_pKeyIndexes;
+  for (std::size_t i = 0; i < indexes.size();) {
+    std::shared_ptr<key_index> existing = indexes[i].lock();
+    if (existing == index)
+      return;
+    if (!existing) {
+      indexes[i] = std::move(indexes.back());
+      indexes.pop_back();
+    } else {
+      i++;
+    }
+  }
+  indexes.push_back(index);
+}
+
+void node_data::invalidate_key_indexes() const {
+  if (!m_pKeyIndexes)
+    return;
+  for (const std::weak_ptr<key_index>& index : *m_pKeyIndexes) {
+    if (std::shared_ptr<key_index> current = index.lock())
+      current->valid = false;
+  }
+  m_pKeyIndexes.reset();
+}
+
 void node_data::reset_sequence() {
-  m_sequence.clear();
-  m_seqSize = 0;
+  collection& c = elements();
+  c.sequence.clear();
+  c.seqSize = 0;
 }
 
 void node_data::reset_map() {
-  m_map.clear();
-  m_undefinedPairs.clear();
+  collection& c = elements();
+  c.map.clear();
+  c.undefinedPairs.clear();
+  reset_key_index();
 }
 
 void node_data::insert_map_pair(node& key, node& value) {
-  m_map.emplace_back(&key, &value);
+  collection& c = elements();
+  c.map.emplace_back(&key, &value);
+
+  if (key_index_is_current()) {
+    // Keep the load factor at or below one half.
+    if (2 * (m_pKeyIndex->count + 1) > m_pKeyIndex->slots.size())
+      build_key_index();
+    else
+      add_to_key_index(c.map.size() - 1);
+  }
 
   if (!key.is_defined() || !value.is_defined())
-    m_undefinedPairs.emplace_back(&key, &value);
+    c.undefinedPairs.emplace_back(&key, &value);
 }
 
 void node_data::convert_to_map(shared_memory_holder pMemory) {
@@ -284,13 +448,14 @@ void node_data::convert_sequence_to_map(shared_memory_holder pMemory) {
   assert(m_type == NodeType::Sequence);
 
   reset_map();
-  for (std::size_t i = 0; i < m_sequence.size(); i++) {
+  const node_seq& sequence = elements().sequence;
+  for (std::size_t i = 0; i < sequence.size(); i++) {
     std::stringstream stream;
     stream << i;
 
     node& key = pMemory->create_node();
     key.set_scalar(stream.str());
-    insert_map_pair(key, *m_sequence[i]);
+    insert_map_pair(key, *sequence[i]);
   }
 
   reset_sequence();
@@ -1,7 +1,12 @@
 #include "yaml-cpp/node/parse.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <sstream>
+#include <thread>
 
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/node/impl.h"
@@ -9,18 +14,8 @@
 #include "nodebuilder.h"
 
 namespace YAML {
-Node Load(const std::string& input) {
-  std::stringstream stream(input);
-  return Load(stream);
-}
-
-Node Load(const char* input) {
-  std::stringstream stream(input);
-  return Load(stream);
-}
-
-Node Load(std::istream& input) {
-  Parser parser(input);
+namespace {
+Node LoadFirstDocument(Parser& parser) {
   NodeBuilder builder;
   if (!parser.HandleNextDocument(builder)) {
     return Node();
@@ -29,44 +24,212 @@ Node Load(std::istream& input) {
   return builder.Root();
 }
 
-Node LoadFile(const std::string& filename) {
+std::vector<Node> LoadAllDocuments(Parser& parser) {
+  std::vector<Node> docs;
+  while (1) {
+    NodeBuilder builder;
+    if (!parser.HandleNextDocument(builder)) {
+      break;
+    }
+    docs.push_back(builder.Root());
+  }
+
+  return docs;
+}
+
+// Reads the whole file into memory, so that it can be parsed in place.
+std::string ReadFile(const std::string& filename) {
   std::ifstream fin(filename.c_str());
   if (!fin) {
     throw BadFile();
   }
-  return Load(fin);
+
+  std::string contents;
+  fin.seekg(0, std::ios_base::end);
+  std::streamoff size = fin.tellg();
+  if (size > 0) {
+    contents.resize(static_cast<std::size_t>(size));
+    fin.seekg(0, std::ios_base::beg);
+    fin.read(&contents[0], size);
+    contents.resize(static_cast<std::size_t>(fin.gcount()));
+  } else {
+    // Not seekable (a pipe, say); just read until the end.
+    fin.clear();
+    contents.assign(std::istreambuf_iterator<char>(fin),
+                    std::istreambuf_iterator<char>());
+  }
+  return contents;
+}
+
+// A piece of the input that starts with a document start marker, or at the
+// start of the input, and the mark of its first character. All but the last
+// piece are followed by the marker that starts the next one.
+struct DocumentRange {
+  const char* data;
+  std::size_t size;
+  Mark start;
+  bool last;
+};
+
+bool IsDocumentStart(const char* p, const char* end) {
+  if (end - p < 3 || p[0] != '-' || p[1] != '-' || p[2] != '-')
+    return false;
+  if (end - p == 3)
+    return true;
+  return p[3] == ' ' || p[3] == '\t' || p[3] == '\n' ||
+         (p[3] == '\r' && end - p > 4 && p[4] == '\n');
+}
+
+// Splits the input before every line that starts with a document start
+// marker. The scanner always starts a new document there, or fails on a
+// quoted scalar that runs into it, so the pieces load on their own to the
+// same documents (see LoadRange). Returns false if the input should not be
+// split: if it is not UTF-8, or if it has directives, which carry over to the
+// next document.
+bool SplitDocuments(const char* data, std::size_t size,
+                    std::vector<DocumentRange>& ranges) {
+  if (size >= 2) {
+    unsigned char b0 = static_cast<unsigned char>(data[0]);
+    unsigned char b1 = static_cast<unsigned char>(data[1]);
+    if (b0 == 0 || b1 == 0 || (b0 == 0xFE && b1 == 0xFF) ||
+        (b0 == 0xFF && b1 == 0xFE))
+      return false;
+  }
+  // Marks do not count a byte order mark.
+  std::size_t bom =
+      size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0 ? 3 : 0;
+
+  const char* first = data + bom;
+  const char* end = data + size;
+  DocumentRange range = {data, 0, Mark(), false};
+  int line = 0;
+  for (const char* p = first; p < end;) {
+    if (*p == '%')
+      return false;
+    if (p != first && IsDocumentStart(p, end)) {
+      range.size = static_cast<std::size_t>(p - range.data);
+      ranges.push_back(range);
+      range.data = p;
+      range.start.pos = static_cast<int>(p - first);
+      range.start.line = line;
+    }
+    const void* eol = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+    if (!eol)
+      break;
+    p = static_cast<const char*>(eol) + 1;
+    line++;
+  }
+  range.size = static_cast<std::size_t>(end - range.data);
+  range.last = true;
+  ranges.push_back(range);
+  return true;
+}
+
+// The documents of one range, or whether loading them threw.
+struct LoadedRange {
+  LoadedRange() : failed(false) {}
+
+  std::vector<Node> docs;
+  bool failed;
+};
+
+// Loads a piece together with the marker that follows it, so that the scanner
+// sees what it would see in the whole input: a scalar that is still open
+// there fails as it would (an unterminated quoted scalar would otherwise be
+// accepted at the end of the piece). The marker starts an empty document,
+// which is dropped.
+void LoadRange(const DocumentRange& range, LoadedRange& loaded) {
+  try {
+    Parser parser;
+    parser.Load(range.data, range.last ? range.size : range.size + 3,
+                range.start);
+    loaded.docs = LoadAllDocuments(parser);
+    if (!range.last)
+      loaded.docs.pop_back();
+  } catch (...) {
+    loaded.failed = true;
+  }
+}
+}
+
+Node Load(const std::string& input) {
+  Parser parser(input.data(), input.size());
+  return LoadFirstDocument(parser);
+}
+
+Node Load(const char* input) {
+  Parser parser(input, std::strlen(input));
+  return LoadFirstDocument(parser);
+}
+
+Node Load(std::istream& input) {
+  Parser parser(input);
+  return LoadFirstDocument(parser);
+}
+
+Node LoadFile(const std::string& filename) {
+  return Load(ReadFile(filename));
 }
 
 std::vector<Node> LoadAll(const std::string& input) {
-  std::stringstream stream(input);
-  return LoadAll(stream);
+  Parser parser(input.data(), input.size());
+  return LoadAllDocuments(parser);
 }
 
 std::vector<Node> LoadAll(const char* input) {
-  std::stringstream stream(input);
-  return LoadAll(stream);
+  Parser parser(input, std::strlen(input));
+  return LoadAllDocuments(parser);
 }
 
 std::vector<Node> LoadAll(std::istream& input) {
-  std::vector<Node> docs;
-
   Parser parser(input);
-  while (1) {
-    NodeBuilder builder;
-    if (!parser.HandleNextDocument(builder)) {
-      break;
-    }
-    docs.push_back(builder.Root());
+  return LoadAllDocuments(parser);
+}
+
+std::vector<Node> LoadAllFromFile(const std::string& filename) {
+  return LoadAll(ReadFile(filename));
+}
+std::vector<Node> LoadAllParallel(const std::string& input,
+                                  std::size_t threads) {
+  std::vector<DocumentRange> ranges;
+  if (!SplitDocuments(input.data(), input.size(), ranges))
+    return LoadAll(input);
+
+  if (threads == 0)
+    threads = std::max(std::thread::hardware_concurrency(), 1u);
+  threads = std::min(threads, ranges.size());
+  if (threads <= 1)
+    return LoadAll(input);
+
+  // Workers take ranges in order, one at a time, so that a few large
+  // documents do not leave the other threads idle.
+  std::vector<LoadedRange> loaded(ranges.size());
+  std::atomic<std::size_t> next(0);
+  std::vector<std::thread> workers;
+  workers.reserve(threads);
+  for (std::size_t i = 0; i < threads; i++) {
+    workers.emplace_back([&ranges, &loaded, &next]() {
+      for (std::size_t j = next++; j < ranges.size(); j = next++)
+        LoadRange(ranges[j], loaded[j]);
+    });
   }
+  for (std::size_t i = 0; i < workers.size(); i++)
+    workers[i].join();
 
+  // A piece can fail differently from the whole input (a flow collection
+  // still open at its end fails there, not where the whole input would), so
+  // malformed input is loaded again serially for the error to report.
+  std::vector<Node> docs;
+  for (std::size_t i = 0; i < loaded.size(); i++) {
+    if (loaded[i].failed)
+      return LoadAll(input);
+    docs.insert(docs.end(), loaded[i].docs.begin(), loaded[i].docs.end());
+  }
   return docs;
 }
 
-std::vector<Node> LoadAllFromFile(const std::string& filename) {
-  std::ifstream fin(filename.c_str());
-  if (!fin) {
-    throw BadFile();
-  }
-  return LoadAll(fin);
+std::vector<Node> LoadAllFromFileParallel(const std::string& filename,
+                                          std::size_t threads) {
+  return LoadAllParallel(ReadFile(filename), threads);
 }
 }  // namespace YAML
@@ -15,6 +15,8 @@ Parser::Parser() {}
 
 Parser::Parser(std::istream& in) { Load(in); }
 
+Parser::Parser(const char* data, std::size_t size) { Load(data, size); }
+
 Parser::~Parser() {}
 
 Parser::operator bool() const {
@@ -26,6 +28,11 @@ void Parser::Load(std::istream& in) {
   m_pDirectives.reset(new Directives);
 }
 
+void Parser::Load(const char* data, std::size_t size, const Mark& start) {
+  m_pScanner.reset(new Scanner(data, size, start));
+  m_pDirectives.reset(new Directives);
+}
+
 bool Parser::HandleNextDocument(EventHandler& eventHandler) {
   if (!m_pScanner.get())
     return false;
@@ -2,23 +2,86 @@
 
 namespace YAML {
 // constructors
-RegEx::RegEx() : m_op(REGEX_EMPTY) {}
+RegEx::RegEx() : m_op(REGEX_EMPTY) { Compile(); }
 
 RegEx::RegEx(REGEX_OP op) : m_op(op) {}
 
-RegEx::RegEx(char ch) : m_op(REGEX_MATCH), m_a(ch) {}
+RegEx::RegEx(char ch) : m_op(REGEX_MATCH), m_a(ch) { Compile(); }
 
-RegEx::RegEx(char a, char z) : m_op(REGEX_RANGE), m_a(a), m_z(z) {}
+RegEx::RegEx(char a, char z) : m_op(REGEX_RANGE), m_a(a), m_z(z) {
+  Compile();
+}
 
 RegEx::RegEx(const std::string& str, REGEX_OP op) : m_op(op) {
   for (std::size_t i = 0; i < str.size(); i++)
     m_params.push_back(RegEx(str[i]));
+  Compile();
+}
+
+// Compile
+// . Works out m_firstChars and m_isCharClass from the operator and from the
+//   (already compiled) parameters.
+void RegEx::Compile() {
+  m_firstChars.reset();
+  m_isCharClass = false;
+
+  bool paramsAreCharClasses = !m_params.empty();
+  for (std::size_t i = 0; i < m_params.size(); i++)
+    paramsAreCharClasses = paramsAreCharClasses && m_params[i].m_isCharClass;
+
+  switch (m_op) {
+    case REGEX_MATCH:
+      m_firstChars.set(static_cast<unsigned char>(m_a));
+      m_isCharClass = true;
+      break;
+    case REGEX_RANGE:
+      // Compare as char, like MatchOpRange does.
+      for (int i = 0; i < 256; i++) {
+        char ch = static_cast<char>(i);
+        if (!(m_a > ch || m_z < ch))
+          m_firstChars.set(i);
+      }
+      m_isCharClass = true;
+      break;
+    case REGEX_OR:
+      for (std::size_t i = 0; i < m_params.size(); i++)
+        m_firstChars |= m_params[i].m_firstChars;
+      m_isCharClass = paramsAreCharClasses;
+      break;
+    case REGEX_AND:
+      if (!m_params.empty())
+        m_firstChars.set();
+      for (std::size_t i = 0; i < m_params.size(); i++)
+        m_firstChars &= m_params[i].m_firstChars;
+      m_isCharClass = paramsAreCharClasses;
+      break;
+    case REGEX_NOT:
+      // Only the complement of a character class is known; otherwise the
+      // inner expression may fail on any character.
+      if (paramsAreCharClasses) {
+        m_firstChars = ~m_params[0].m_firstChars;
+        m_isCharClass = true;
+      } else if (!m_params.empty()) {
+        m_firstChars.set();
+      }
+      break;
+    case REGEX_SEQ:
+      if (m_params.empty())
+        m_firstChars.set();
+      else
+        m_firstChars = m_params[0].m_firstChars;
+      break;
+    case REGEX_EMPTY:
+      m_firstChars.set();
+      break;
+  }
 }
 
 // combination constructors
 RegEx operator!(const RegEx& ex) {
   RegEx ret(REGEX_NOT);
   ret.m_params.push_back(ex);
+  ret.Compile();
   return ret;
 }
 
@@ -26,6 +89,7 @@ RegEx operator||(const RegEx& ex1, const RegEx& ex2) {
   RegEx ret(REGEX_OR);
   ret.m_params.push_back(ex1);
   ret.m_params.push_back(ex2);
+  ret.Compile();
   return ret;
 }
 
@@ -33,6 +97,7 @@ RegEx operator&&(const RegEx& ex1, const RegEx& ex2) {
   RegEx ret(REGEX_AND);
   ret.m_params.push_back(ex1);
   ret.m_params.push_back(ex2);
+  ret.Compile();
   return ret;
 }
 
@@ -40,6 +105,7 @@ RegEx operator+(const RegEx& ex1, const RegEx& ex2) {
   RegEx ret(REGEX_SEQ);
   ret.m_params.push_back(ex1);
   ret.m_params.push_back(ex2);
+  ret.Compile();
   return ret;
 }
 }
@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <bitset>
 #include <string>
 #include <vector>
 
@@ -28,6 +29,9 @@ enum REGEX_OP {
 // simplified regular expressions
 // . Only straightforward matches (no repeated characters)
 // . Only matches from start of string
+// . Each expression is compiled, as it is built, into the set of characters
+//   that a match can start with, so most mismatches take a single table
+//   lookup instead of a walk over the whole tree
 class YAML_CPP_API RegEx {
  public:
   RegEx();
@@ -52,9 +56,14 @@ class YAML_CPP_API RegEx {
   template <typename Source>
   int Match(const Source& source) const;
 
+  // The characters that a match can start with.
+  const std::bitset<256>& FirstChars() const { return m_firstChars; }
+
  private:
   RegEx(REGEX_OP op);
 
+  void Compile();
+
   template <typename Source>
   bool IsValidSource(const Source& source) const;
   template <typename Source>
@@ -79,6 +88,12 @@ class YAML_CPP_API RegEx {
   REGEX_OP m_op;
   char m_a, m_z;
   std::vector<RegEx> m_params;
+
+  // A match is only possible if the first character is in m_firstChars. If
+  // m_isCharClass is set, the converse holds too, and the match is always
+  // one character long.
+  std::bitset<256> m_firstChars;
+  bool m_isCharClass;
 };
 }
 
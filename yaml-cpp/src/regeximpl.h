@@ -71,6 +71,11 @@ inline int RegEx::Match(const Source& source) const {
 
 template <typename Source>
 inline int RegEx::MatchUnchecked(const Source& source) const {
+  if (!m_firstChars.test(static_cast<unsigned char>(source[0])))
+    return -1;
+  if (m_isCharClass)
+    return 1;
+
   switch (m_op) {
     case REGEX_EMPTY:
       return MatchOpEmpty(source);
@@ -14,6 +14,13 @@ Scanner::Scanner(std::istream& in)
       m_simpleKeyAllowed(false),
       m_canBeJSONFlow(false) {}
 
+Scanner::Scanner(const char* data, std::size_t size, const Mark& start)
+    : INPUT(data, size, start),
+      m_startedStream(false),
+      m_endedStream(false),
+      m_simpleKeyAllowed(false),
+      m_canBeJSONFlow(false) {}
+
 Scanner::~Scanner() {}
 
 bool Scanner::empty() {
@@ -260,7 +267,7 @@ void Scanner::EndStream() {
 }
 
 Token* Scanner::PushToken(Token::TYPE type) {
-  m_tokens.push(Token(type, INPUT.mark()));
+  m_tokens.push(type, INPUT.mark());
   return &m_tokens.back();
 }
 
@@ -362,9 +369,9 @@ void Scanner::PopIndent() {
   }
 
   if (indent.type == IndentMarker::SEQ) {
-    m_tokens.push(Token(Token::BLOCK_SEQ_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_SEQ_END, INPUT.mark());
   } else if (indent.type == IndentMarker::MAP) {
-    m_tokens.push(Token(Token::BLOCK_MAP_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_MAP_END, INPUT.mark());
   }
 }
 
@@ -1,13 +1,134 @@
 #include "scanscalar.h"
 
 #include <algorithm>
+#include <bitset>
 
 #include "exp.h"
 #include "regeximpl.h"
 #include "stream.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define YAML_SCAN_SSE2
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define YAML_SCAN_AVX2
+#endif
+
+#if defined(_MSC_VER) && defined(YAML_SCAN_SSE2)
+#include <intrin.h>
+#endif
+
 namespace YAML {
+namespace {
+#ifdef YAML_SCAN_SSE2
+inline int LowestSetBit(unsigned int mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+// Finds runs of ordinary characters in phase #1 of ScanScalar: characters
+// that cannot start a line break, an escape or the end of the scalar, so
+// they can be copied without testing any of those one by one.
+class RunFinder {
+ public:
+  RunFinder(const ScanScalarParams& params) : m_numStops(-1) {
+    // Exp::Empty() only matches at the end of the input.
+    if (params.end != &Exp::Empty())
+      m_stops = params.end->FirstChars();
+    m_stops |= Exp::Break().FirstChars();
+    m_stops.set(static_cast<unsigned char>(Stream::eof()));
+    if (params.escape)
+      m_stops.set(static_cast<unsigned char>(params.escape));
+  }
+
+  // Returns the length of the run at the start of [begin, end).
+  std::size_t Find(const char* begin, const char* end) {
+    const char* p = begin;
+
+    // Most runs are short, so look at a few characters before setting up
+    // the vectorized search.
+    for (const char* short_end = std::min(p + kShortRun, end); p < short_end;
+         ++p) {
+      if (IsStop(*p))
+        return p - begin;
+    }
+
+#ifdef YAML_SCAN_SSE2
+    if (m_numStops < 0)
+      PrepareVectors();
+    if (m_numStops <= kMaxVectorStops) {
+#ifdef YAML_SCAN_AVX2
+      for (; end - p >= 32; p += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i hits = _mm256_setzero_si256();
+        for (int i = 0; i < m_numStops; i++)
+          hits = _mm256_or_si256(
+              hits, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(m_stopChars[i])));
+        unsigned int mask =
+            static_cast<unsigned int>(_mm256_movemask_epi8(hits));
+        if (mask)
+          return p - begin + LowestSetBit(mask);
+      }
+#endif
+      for (; end - p >= 16; p += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i hits = _mm_setzero_si128();
+        for (int i = 0; i < m_numStops; i++)
+          hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, m_stopVectors[i]));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(hits));
+        if (mask)
+          return p - begin + LowestSetBit(mask);
+      }
+    }
+#endif
+
+    while (p < end && !IsStop(*p))
+      ++p;
+    return p - begin;
+  }
+
+ private:
+  enum { kShortRun = 8, kMaxVectorStops = 16 };
+
+  bool IsStop(char ch) const {
+    return m_stops.test(static_cast<unsigned char>(ch));
+  }
+
+#ifdef YAML_SCAN_SSE2
+  void PrepareVectors() {
+    m_numStops = static_cast<int>(m_stops.count());
+    if (m_numStops > kMaxVectorStops)
+      return;
+    int n = 0;
+    for (int i = 0; i < 256; i++) {
+      if (m_stops.test(i)) {
+        m_stopChars[n] = static_cast<char>(i);
+        m_stopVectors[n] = _mm_set1_epi8(static_cast<char>(i));
+        n++;
+      }
+    }
+  }
+
+  char m_stopChars[kMaxVectorStops];
+  __m128i m_stopVectors[kMaxVectorStops];
+#endif
+
+  std::bitset<256> m_stops;
+  int m_numStops;
+};
+}
+
 // ScanScalar
 // . This is where the scalar magic happens.
 //
@@ -18,19 +139,20 @@ namespace YAML {
 //
 // . Depending on the parameters given, we store or stop
 //   and different places in the above flow.
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
+void ScanScalar(Stream& INPUT, ScanScalarParams& params, std::string& scalar) {
   bool foundNonEmptyLine = false;
   bool pastOpeningBreak = (params.fold == FOLD_FLOW);
   bool emptyLine = false, moreIndented = false;
   int foldedNewlineCount = 0;
   bool foldedNewlineStartedMoreIndented = false;
   std::size_t lastEscapedChar = std::string::npos;
-  std::string scalar;
+  scalar.clear();
   params.leadingSpaces = false;
 
   if (!params.end) {
     params.end = &Exp::Empty();
   }
+  RunFinder runs(params);
 
   while (INPUT) {
     // ********************************
@@ -79,6 +201,22 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
       if (ch != ' ' && ch != '\t') {
         lastNonWhitespaceChar = scalar.size();
       }
+
+      // and, if the input is in memory, the run of ordinary characters after
+      // it (none of which can be at the start of a line)
+      if (std::size_t available = INPUT.buffered_size()) {
+        const char* run = INPUT.buffered_pos();
+        std::size_t length = runs.Find(run, run + available);
+        if (length > 0) {
+          scalar.append(run, length);
+          std::size_t last = length;
+          while (last > 0 && (run[last - 1] == ' ' || run[last - 1] == '\t'))
+            last--;
+          if (last > 0)
+            lastNonWhitespaceChar = scalar.size() - length + last;
+          INPUT.eat_in_line(length);
+        }
+      }
     }
 
     // eof? if we're looking to eat something, then we throw
@@ -244,7 +382,5 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     default:
       break;
   }
-
-  return scalar;
 }
 }
@@ -1,4 +1,5 @@
 #include <sstream>
+#include <utility>
 
 #include "exp.h"
 #include "regex_yaml.h"
@@ -29,7 +30,7 @@ void Scanner::ScanDirective() {
   m_canBeJSONFlow = false;
 
   // store pos and eat indicator
-  Token token(Token::DIRECTIVE, INPUT.mark());
+  Token& token = m_tokens.push(Token::DIRECTIVE, INPUT.mark());
   INPUT.eat(1);
 
   // read name
@@ -53,8 +54,6 @@ void Scanner::ScanDirective() {
 
     token.params.push_back(param);
   }
-
-  m_tokens.push(token);
 }
 
 // DocStart
@@ -67,7 +66,7 @@ void Scanner::ScanDocStart() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(3);
-  m_tokens.push(Token(Token::DOC_START, mark));
+  m_tokens.push(Token::DOC_START, mark);
 }
 
 // DocEnd
@@ -80,7 +79,7 @@ void Scanner::ScanDocEnd() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(3);
-  m_tokens.push(Token(Token::DOC_END, mark));
+  m_tokens.push(Token::DOC_END, mark);
 }
 
 // FlowStart
@@ -97,7 +96,7 @@ void Scanner::ScanFlowStart() {
   m_flows.push(flowType);
   Token::TYPE type =
       (flowType == FLOW_SEQ ? Token::FLOW_SEQ_START : Token::FLOW_MAP_START);
-  m_tokens.push(Token(type, mark));
+  m_tokens.push(type, mark);
 }
 
 // FlowEnd
@@ -108,7 +107,7 @@ void Scanner::ScanFlowEnd() {
   // we might have a solo entry in the flow context
   if (InFlowContext()) {
     if (m_flows.top() == FLOW_MAP && VerifySimpleKey())
-      m_tokens.push(Token(Token::VALUE, INPUT.mark()));
+      m_tokens.push(Token::VALUE, INPUT.mark());
     else if (m_flows.top() == FLOW_SEQ)
       InvalidateSimpleKey();
   }
@@ -127,7 +126,7 @@ void Scanner::ScanFlowEnd() {
   m_flows.pop();
 
   Token::TYPE type = (flowType ? Token::FLOW_SEQ_END : Token::FLOW_MAP_END);
-  m_tokens.push(Token(type, mark));
+  m_tokens.push(type, mark);
 }
 
 // FlowEntry
@@ -135,7 +134,7 @@ void Scanner::ScanFlowEntry() {
   // we might have a solo entry in the flow context
   if (InFlowContext()) {
     if (m_flows.top() == FLOW_MAP && VerifySimpleKey())
-      m_tokens.push(Token(Token::VALUE, INPUT.mark()));
+      m_tokens.push(Token::VALUE, INPUT.mark());
     else if (m_flows.top() == FLOW_SEQ)
       InvalidateSimpleKey();
   }
@@ -146,7 +145,7 @@ void Scanner::ScanFlowEntry() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::FLOW_ENTRY, mark));
+  m_tokens.push(Token::FLOW_ENTRY, mark);
 }
 
 // BlockEntry
@@ -166,7 +165,7 @@ void Scanner::ScanBlockEntry() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::BLOCK_ENTRY, mark));
+  m_tokens.push(Token::BLOCK_ENTRY, mark);
 }
 
 // Key
@@ -185,7 +184,7 @@ void Scanner::ScanKey() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::KEY, mark));
+  m_tokens.push(Token::KEY, mark);
 }
 
 // Value
@@ -214,7 +213,7 @@ void Scanner::ScanValue() {
   // eat
   Mark mark = INPUT.mark();
   INPUT.eat(1);
-  m_tokens.push(Token(Token::VALUE, mark));
+  m_tokens.push(Token::VALUE, mark);
 }
 
 // AnchorOrAlias
@@ -247,9 +246,8 @@ void Scanner::ScanAnchorOrAlias() {
                                               : ErrorMsg::CHAR_IN_ANCHOR);
 
   // and we're done
-  Token token(alias ? Token::ALIAS : Token::ANCHOR, mark);
-  token.value = name;
-  m_tokens.push(token);
+  Token& token = m_tokens.push(alias ? Token::ALIAS : Token::ANCHOR, mark);
+  token.value = std::move(name);
 }
 
 // Tag
@@ -259,7 +257,7 @@ void Scanner::ScanTag() {
   m_simpleKeyAllowed = false;
   m_canBeJSONFlow = false;
 
-  Token token(Token::TAG, INPUT.mark());
+  Token& token = m_tokens.push(Token::TAG, INPUT.mark());
 
   // eat the indicator
   INPUT.get();
@@ -287,14 +285,10 @@ void Scanner::ScanTag() {
       token.data = Tag::NAMED_HANDLE;
     }
   }
-
-  m_tokens.push(token);
 }
 
 // PlainScalar
 void Scanner::ScanPlainScalar() {
-  std::string scalar;
-
   // set up the scanning parameters
   ScanScalarParams params;
   params.end =
@@ -311,8 +305,8 @@ void Scanner::ScanPlainScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
-  scalar = ScanScalar(INPUT, params);
+  Token& token = m_tokens.push(Token::PLAIN_SCALAR, INPUT.mark());
+  ScanScalar(INPUT, params, token.value);
 
   // can have a simple key only if we ended the scalar by starting a new line
   m_simpleKeyAllowed = params.leadingSpaces;
@@ -321,16 +315,10 @@ void Scanner::ScanPlainScalar() {
   // finally, check and see if we ended on an illegal character
   // if(Exp::IllegalCharInScalar.Matches(INPUT))
   //	throw ParserException(INPUT.mark(), ErrorMsg::CHAR_IN_SCALAR);
-
-  Token token(Token::PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 
 // QuotedScalar
 void Scanner::ScanQuotedScalar() {
-  std::string scalar;
-
   // peek at single or double quote (don't eat because we need to preserve (for
   // the time being) the input position)
   char quote = INPUT.peek();
@@ -338,8 +326,8 @@ void Scanner::ScanQuotedScalar() {
 
   // setup the scanning parameters
   ScanScalarParams params;
-  RegEx end = (single ? RegEx(quote) && !Exp::EscSingleQuote() : RegEx(quote));
-  params.end = &end;
+  params.end = single ? &Exp::EndSingleQuotedScalar()
+                      : &Exp::EndDoubleQuotedScalar();
   params.eatEnd = true;
   params.escape = (single ? '\'' : '\\');
   params.indent = 0;
@@ -352,19 +340,15 @@ void Scanner::ScanQuotedScalar() {
   // insert a potential simple key
   InsertPotentialSimpleKey();
 
-  Mark mark = INPUT.mark();
+  Token& token = m_tokens.push(Token::NON_PLAIN_SCALAR, INPUT.mark());
 
   // now eat that opening quote
   INPUT.get();
 
   // and scan
-  scalar = ScanScalar(INPUT, params);
+  ScanScalar(INPUT, params, token.value);
   m_simpleKeyAllowed = false;
   m_canBeJSONFlow = true;
-
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 
 // BlockScalarToken
@@ -373,8 +357,6 @@ void Scanner::ScanQuotedScalar() {
 // of the scalar),
 //   and then we need to figure out what level of indentation we'll be using.
 void Scanner::ScanBlockScalar() {
-  std::string scalar;
-
   ScanScalarParams params;
   params.indent = 1;
   params.detectIndent = true;
@@ -423,15 +405,12 @@ void Scanner::ScanBlockScalar() {
   params.trimTrailingSpaces = false;
   params.onTabInIndentation = THROW;
 
-  scalar = ScanScalar(INPUT, params);
+  Token& token = m_tokens.push(Token::NON_PLAIN_SCALAR, mark);
+  ScanScalar(INPUT, params, token.value);
 
   // simple keys always ok after block scalars (since we're gonna start a new
   // line anyways)
   m_simpleKeyAllowed = true;
   m_canBeJSONFlow = false;
-
-  Token token(Token::NON_PLAIN_SCALAR, mark);
-  token.value = scalar;
-  m_tokens.push(token);
 }
 }
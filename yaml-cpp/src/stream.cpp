@@ -192,13 +192,65 @@ inline void QueueUnicodeCodepoint(std::deque<char>& q, unsigned long ch) {
 
 Stream::Stream(std::istream& input)
     : m_input(input),
+      m_isBuffered(false),
+      m_pCurrent(0),
+      m_pEnd(0),
+      m_pPrefetched(new unsigned char[YAML_PREFETCH_SIZE]),
+      m_nPrefetchedAvailable(0),
+      m_nPrefetchedUsed(0) {
+  if (!input)
+    return;
+
+  DetectCharSet();
+  ReadAheadTo(0);
+}
+
+Stream::Stream(const char* data, std::size_t size, const Mark& start)
+    : m_pBufferInput(new std::istringstream),
+      m_input(*m_pBufferInput),
+      m_mark(start),
+      m_isBuffered(false),
+      m_pCurrent(0),
+      m_pEnd(0),
       m_pPrefetched(new unsigned char[YAML_PREFETCH_SIZE]),
       m_nPrefetchedAvailable(0),
       m_nPrefetchedUsed(0) {
   typedef std::istream::traits_type char_traits;
 
-  if (!input)
+  // Same as DetectCharSet(), but ungetting a byte just means stepping back.
+  std::size_t nIntroUsed = 0;
+  UtfIntroState state = uis_start;
+  for (; !s_introFinalState[state];) {
+    std::istream::int_type ch =
+        nIntroUsed < size
+            ? char_traits::to_int_type(data[nIntroUsed])
+            : char_traits::eof();
+    nIntroUsed++;
+    UtfIntroCharType charType = IntroCharTypeOf(ch);
+    nIntroUsed -= s_introUngetCount[state][charType];
+    state = s_introTransitions[state][charType];
+  }
+  if (nIntroUsed > size)
+    nIntroUsed = size;
+
+  if (state == uis_utf8 || state == uis_error) {
+    m_charSet = utf8;
+    m_isBuffered = true;
+    m_pCurrent = data + nIntroUsed;
+    m_pEnd = data + size;
     return;
+  }
+
+  m_pBufferInput->str(std::string(data + nIntroUsed, size - nIntroUsed));
+  SetCharSet(state);
+  ReadAheadTo(0);
+}
+
+Stream::~Stream() { delete[] m_pPrefetched; }
+
+void Stream::DetectCharSet() {
+  typedef std::istream::traits_type char_traits;
+  std::istream& input = m_input;
 
   // Determine (or guess) the character-set by reading the BOM, if any.  See
   // the YAML specification for the determination algorithm.
@@ -221,7 +273,11 @@ Stream::Stream(std::istream& input)
     state = newState;
   }
 
-  switch (state) {
+  SetCharSet(state);
+}
+
+void Stream::SetCharSet(int introState) {
+  switch (introState) {
     case uis_utf8:
       m_charSet = utf8;
       break;
@@ -241,40 +297,15 @@ Stream::Stream(std::istream& input)
       m_charSet = utf8;
       break;
   }
-
-  ReadAheadTo(0);
-}
-
-Stream::~Stream() { delete[] m_pPrefetched; }
-
-char Stream::peek() const {
-  if (m_readahead.empty()) {
-    return Stream::eof();
-  }
-
-  return m_readahead[0];
 }
 
 Stream::operator bool() const {
+  if (m_isBuffered)
+    return m_pCurrent < m_pEnd;
   return m_input.good() ||
          (!m_readahead.empty() && m_readahead[0] != Stream::eof());
 }
 
-// get
-// . Extracts a character from the stream and updates our position
-char Stream::get() {
-  char ch = peek();
-  AdvanceCurrent();
-  m_mark.column++;
-
-  if (ch == '\n') {
-    m_mark.column = 0;
-    m_mark.line++;
-  }
-
-  return ch;
-}
-
 // get
 // . Extracts 'n' characters from the stream and updates our position
 std::string Stream::get(int n) {
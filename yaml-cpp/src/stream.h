@@ -13,7 +13,9 @@
 #include <deque>
 #include <ios>
 #include <iostream>
+#include <memory>
 #include <set>
+#include <sstream>
 #include <string>
 
 namespace YAML {
@@ -22,6 +24,11 @@ class Stream : private noncopyable {
   friend class StreamCharSource;
 
   Stream(std::istream& input);
+  // Reads straight out of a buffer of 'size' bytes, which must outlive the
+  // stream. UTF-8 input is scanned in place; other encodings are decoded
+  // through the readahead queue as usual. Marks are counted from 'start',
+  // for a buffer that is only part of a larger input.
+  Stream(const char* data, std::size_t size, const Mark& start = Mark());
   ~Stream();
 
   operator bool() const;
@@ -34,6 +41,19 @@ class Stream : private noncopyable {
 
   static char eof() { return 0x04; }
 
+  // In a buffered stream, the characters that are left, for scanning ahead
+  // in bulk; in any other stream, nothing.
+  const char* buffered_pos() const { return m_pCurrent; }
+  std::size_t buffered_size() const {
+    return m_isBuffered ? static_cast<std::size_t>(m_pEnd - m_pCurrent) : 0;
+  }
+  // Eats 'n' buffered characters, none of which may be a newline.
+  void eat_in_line(std::size_t n) {
+    m_pCurrent += n;
+    m_mark.pos += static_cast<int>(n);
+    m_mark.column += static_cast<int>(n);
+  }
+
   const Mark mark() const { return m_mark; }
   int pos() const { return m_mark.pos; }
   int line() const { return m_mark.line; }
@@ -43,15 +63,24 @@ class Stream : private noncopyable {
  private:
   enum CharacterSet { utf8, utf16le, utf16be, utf32le, utf32be };
 
+  std::unique_ptr<std::istringstream> m_pBufferInput;
   std::istream& m_input;
   Mark m_mark;
 
+  // Set when reading UTF-8 from a buffer, in which case the readahead queue
+  // is unused and [m_pCurrent, m_pEnd) is what is left of the input.
+  bool m_isBuffered;
+  const char* m_pCurrent;
+  const char* m_pEnd;
+
   CharacterSet m_charSet;
   mutable std::deque<char> m_readahead;
   unsigned char* const m_pPrefetched;
   mutable size_t m_nPrefetchedAvailable;
   mutable size_t m_nPrefetchedUsed;
 
+  void DetectCharSet();
+  void SetCharSet(int introState);
   void AdvanceCurrent();
   char CharAt(size_t i) const;
   bool ReadAheadTo(size_t i) const;
@@ -62,12 +91,48 @@ class Stream : private noncopyable {
   unsigned char GetNextByte() const;
 };
 
+inline char Stream::peek() const {
+  if (m_isBuffered)
+    return m_pCurrent < m_pEnd ? *m_pCurrent : Stream::eof();
+  if (m_readahead.empty()) {
+    return Stream::eof();
+  }
+
+  return m_readahead[0];
+}
+
+// get
+// . Extracts a character from the stream and updates our position
+inline char Stream::get() {
+  char ch = peek();
+  if (m_isBuffered) {
+    if (m_pCurrent < m_pEnd)
+      m_pCurrent++;
+    m_mark.pos++;
+  } else {
+    AdvanceCurrent();
+  }
+  m_mark.column++;
+
+  if (ch == '\n') {
+    m_mark.column = 0;
+    m_mark.line++;
+  }
+
+  return ch;
+}
+
 // CharAt
-// . Unchecked access
-inline char Stream::CharAt(size_t i) const { return m_readahead[i]; }
+// . Unchecked access; in a buffer, everything past the end reads as eof()
+inline char Stream::CharAt(size_t i) const {
+  if (m_isBuffered)
+    return i < static_cast<size_t>(m_pEnd - m_pCurrent) ? m_pCurrent[i]
+                                                         : Stream::eof();
+  return m_readahead[i];
+}
 
 inline bool Stream::ReadAheadTo(size_t i) const {
-  if (m_readahead.size() > i)
+  if (m_isBuffered || m_readahead.size() > i)
     return true;
   return _ReadAheadTo(i);
 }
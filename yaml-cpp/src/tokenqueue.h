@@ -0,0 +1,92 @@
+#ifndef TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "token.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/noncopyable.h"
+
+namespace YAML {
+
+// The scanner's queue of tokens: a ring of token slots. A popped slot is
+// reused by a later push, and the strings of its token keep their capacity,
+// so a steady stream of tokens does not allocate. A queued token never moves
+// (simple keys keep pointers to them); growing the ring only moves the slot
+// pointers.
+class TokenQueue : private noncopyable {
+ public:
+  TokenQueue() : m_head(0), m_size(0) {}
+
+  bool empty() const { return m_size == 0; }
+  std::size_t size() const { return m_size; }
+
+  Token& front() {
+    assert(m_size > 0);
+    return *m_slots[m_head];
+  }
+  const Token& front() const {
+    assert(m_size > 0);
+    return *m_slots[m_head];
+  }
+  Token& back() {
+    assert(m_size > 0);
+    return *m_slots[(m_head + m_size - 1) & (m_slots.size() - 1)];
+  }
+
+  // Queues a token with an empty value and no params, and returns it.
+  Token& push(Token::TYPE type, const Mark& mark) {
+    if (m_size == m_slots.size())
+      grow();
+
+    std::unique_ptr<Token>& slot =
+        m_slots[(m_head + m_size) & (m_slots.size() - 1)];
+    m_size++;
+    if (!slot) {
+      slot.reset(new Token(type, mark));
+      return *slot;
+    }
+
+    slot->status = Token::VALID;
+    slot->type = type;
+    slot->mark = mark;
+    slot->value.clear();
+    slot->params.clear();
+    slot->data = 0;
+    return *slot;
+  }
+
+  void pop() {
+    assert(m_size > 0);
+    m_head = (m_head + 1) & (m_slots.size() - 1);
+    m_size--;
+  }
+
+ private:
+  // Doubles the ring, keeping the queued tokens in order from the start.
+  void grow() {
+    std::vector<std::unique_ptr<Token>> slots(
+        m_slots.empty() ? 16 : 2 * m_slots.size());
+    for (std::size_t i = 0; i < m_slots.size(); i++)
+      slots[i] = std::move(m_slots[(m_head + i) & (m_slots.size() - 1)]);
+    m_slots.swap(slots);
+    m_head = 0;
+  }
+
+ private:
+  std::vector<std::unique_ptr<Token>> m_slots;  // a power of two of them
+  std::size_t m_head;
+  std::size_t m_size;
+};
+}
+
+#endif  // TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,68 @@
+// Times decoding a loaded list of numbers element by element with as<T>(),
+// against decoding it in bulk with DecodeNumbers, for a sequence and for a
+// scalar of space-separated numbers.
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+std::string make_numbers(std::size_t count, const char* separator) {
+  std::string numbers;
+  for (std::size_t i = 0; i < count; i++) {
+    if (i > 0)
+      numbers += separator;
+    numbers += std::to_string((i * 7919) % 100000) + "." +
+               std::to_string(i % 100);
+  }
+  return numbers;
+}
+
+template <typename Decode>
+double time_decode(const YAML::Node& node, std::size_t count,
+                   std::size_t rounds, Decode decode) {
+  std::vector<double> values;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < rounds; i++) {
+    if (!decode(node, values) || values.size() != count) {
+      std::cerr << "decode failed\n";
+      std::exit(1);
+    }
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / (rounds * count);
+}
+
+bool decode_each(const YAML::Node& node, std::vector<double>& values) {
+  values.clear();
+  for (YAML::const_iterator it = node.begin(); it != node.end(); ++it)
+    values.push_back(it->as<double>());
+  return true;
+}
+
+bool decode_bulk(const YAML::Node& node, std::vector<double>& values) {
+  return YAML::DecodeNumbers(node, values);
+}
+}
+
+int main(int argc, char** argv) {
+  std::size_t rounds = argc > 1 ? std::atoi(argv[1]) : 20;
+  const std::size_t count = 100000;
+
+  YAML::Node sequence = YAML::Load("[" + make_numbers(count, ", ") + "]");
+  YAML::Node scalar = YAML::Load(make_numbers(count, " "));
+
+  std::cout << "ns/number\n";
+  std::cout << "sequence, as<double>()\t"
+            << time_decode(sequence, count, rounds, decode_each) << "\n";
+  std::cout << "sequence, DecodeNumbers\t"
+            << time_decode(sequence, count, rounds, decode_bulk) << "\n";
+  std::cout << "scalar, DecodeNumbers\t"
+            << time_decode(scalar, count, rounds, decode_bulk) << "\n";
+  return 0;
+}
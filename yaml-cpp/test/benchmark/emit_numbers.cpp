@@ -0,0 +1,79 @@
+// Times emitting a flow sequence of numbers one value at a time with <<,
+// against emitting it with WriteFlowSeq, and counts the heap allocations made
+// per number.
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+  allocations++;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+namespace {
+template <typename T>
+std::size_t emit_each(const std::vector<T>& values) {
+  YAML::Emitter out;
+  out << YAML::Flow << YAML::BeginSeq;
+  for (std::size_t i = 0; i < values.size(); i++)
+    out << values[i];
+  out << YAML::EndSeq;
+  return out.size();
+}
+
+template <typename T>
+std::size_t emit_bulk(const std::vector<T>& values) {
+  YAML::Emitter out;
+  out.WriteFlowSeq(values.data(), values.size());
+  return out.size();
+}
+
+template <typename T, typename Emit>
+void report(const char* name, const std::vector<T>& values, std::size_t rounds,
+            Emit emit) {
+  std::size_t before = allocations;
+  std::size_t size = 0;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < rounds; i++)
+    size += emit(values);
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  double total = static_cast<double>(values.size()) * rounds;
+  std::cout << name << "\t" << elapsed.count() / total << "\t"
+            << (allocations - before) / total << "\t" << size / rounds
+            << "\n";
+}
+}
+
+int main(int argc, char** argv) {
+  std::size_t rounds = argc > 1 ? std::atoi(argv[1]) : 10;
+  const std::size_t count = 100000;
+
+  std::vector<double> doubles;
+  std::vector<int> ints;
+  for (std::size_t i = 0; i < count; i++) {
+    doubles.push_back(static_cast<double>((i * 7919) % 100000) / 64 + 0.1);
+    ints.push_back(static_cast<int>((i * 7919) % 100000) - 50000);
+  }
+
+  std::cout << "\tns/number\tallocations/number\tbytes\n";
+  report("double, <<", doubles, rounds, emit_each<double>);
+  report("double, WriteFlowSeq", doubles, rounds, emit_bulk<double>);
+  report("int, <<", ints, rounds, emit_each<int>);
+  report("int, WriteFlowSeq", ints, rounds, emit_bulk<int>);
+  return 0;
+}
@@ -0,0 +1,53 @@
+// Times string-key lookups on maps of increasing width. Wide maps are looked
+// up through a hash index, so the time per lookup should stay roughly flat.
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<std::string> make_keys(std::size_t width) {
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < width; i++)
+    keys.push_back("key" + std::to_string(i));
+  return keys;
+}
+
+// Returns the time per lookup in nanoseconds.
+double time_lookups(const YAML::Node& map, const std::vector<std::string>& keys,
+                    std::size_t lookups) {
+  YAML::Node node = map;
+  std::size_t found = 0;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < lookups; i++) {
+    if (node[keys[(i * 7919) % keys.size()]])
+      found++;
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  if (found != lookups) {
+    std::cerr << "lookup failed\n";
+    std::exit(1);
+  }
+  return elapsed.count() / lookups;
+}
+}
+
+int main(int argc, char** argv) {
+  std::size_t lookups = argc > 1 ? std::atoi(argv[1]) : 200000;
+  const std::size_t widths[] = {4, 16, 64, 256, 1024, 4096};
+
+  std::cout << "width\tns/lookup\n";
+  for (std::size_t width : widths) {
+    std::vector<std::string> keys = make_keys(width);
+    YAML::Node map;
+    for (std::size_t i = 0; i < width; i++)
+      map[keys[i]] = i;
+    std::cout << width << "\t" << time_lookups(map, keys, lookups) << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Times the scanner alone and the scanner with the parser on a display-list
+// like document, and counts the heap allocations made per token.
+#include "scanner.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+namespace {
+std::size_t allocations = 0;
+}
+
+void* operator new(std::size_t size) {
+  allocations++;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+namespace {
+class NullEventHandler : public YAML::EventHandler {
+ public:
+  typedef YAML::Mark Mark;
+  typedef YAML::anchor_t anchor_t;
+
+  virtual void OnDocumentStart(const Mark&) {}
+  virtual void OnDocumentEnd() {}
+  virtual void OnNull(const Mark&, anchor_t) {}
+  virtual void OnAlias(const Mark&, anchor_t) {}
+  virtual void OnScalar(const Mark&, const std::string&, anchor_t,
+                        const std::string&) {}
+  virtual void OnSequenceStart(const Mark&, const std::string&, anchor_t,
+                               YAML::EmitterStyle::value) {}
+  virtual void OnSequenceEnd() {}
+  virtual void OnMapStart(const Mark&, const std::string&, anchor_t,
+                          YAML::EmitterStyle::value) {}
+  virtual void OnMapEnd() {}
+};
+
+std::string make_display_list(std::size_t ops) {
+  std::string yaml = "ops:\n";
+  for (std::size_t i = 0; i < ops; i++) {
+    std::string n = std::to_string(i % 997);
+    yaml += "  - op: drawRect\n";
+    yaml += "    rect: [" + n + ".5, 30, 200.25, " + n + "]\n";
+    yaml += "    paint: {color: '#ff336699', style: fill, antialias: true}\n";
+    yaml += "    label: \"a label that is too long for a short string " + n +
+            "\"\n";
+  }
+  return yaml;
+}
+
+std::size_t count_tokens(const std::string& yaml) {
+  YAML::Scanner scanner(yaml.data(), yaml.size());
+  std::size_t tokens = 0;
+  while (!scanner.empty()) {
+    scanner.pop();
+    tokens++;
+  }
+  return tokens;
+}
+
+void parse(const std::string& yaml) {
+  YAML::Parser parser(yaml.data(), yaml.size());
+  NullEventHandler handler;
+  while (parser.HandleNextDocument(handler)) {
+  }
+}
+
+template <typename Run>
+void report(const char* name, const std::string& yaml, std::size_t tokens,
+            std::size_t rounds, Run run) {
+  std::size_t before = allocations;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < rounds; i++)
+    run(yaml);
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  double total = static_cast<double>(tokens) * rounds;
+  std::cout << name << "\t" << total / elapsed.count() / 1e6 << "\t"
+            << (allocations - before) / total << "\n";
+}
+}
+
+int main(int argc, char** argv) {
+  std::size_t rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+  std::string yaml = make_display_list(20000);
+  std::size_t tokens = count_tokens(yaml);
+
+  std::cout << tokens << " tokens, " << yaml.size() / 1e6 << " MB\n";
+  std::cout << "\tMtokens/s\tallocations/token\n";
+  report("scan", yaml, tokens, rounds, count_tokens);
+  report("parse", yaml, tokens, rounds, parse);
+  return 0;
+}
@@ -0,0 +1,96 @@
+// Times the scanner on documents made of large flow scalars: flow sequences
+// of long plain, single-quoted and double-quoted scalars, holding either text
+// or space-separated numbers.
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/yaml.h"  // IWYU pragma: keep
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+class NullEventHandler : public YAML::EventHandler {
+ public:
+  typedef YAML::Mark Mark;
+  typedef YAML::anchor_t anchor_t;
+
+  virtual void OnDocumentStart(const Mark&) {}
+  virtual void OnDocumentEnd() {}
+  virtual void OnNull(const Mark&, anchor_t) {}
+  virtual void OnAlias(const Mark&, anchor_t) {}
+  virtual void OnScalar(const Mark&, const std::string&, anchor_t,
+                        const std::string&) {}
+  virtual void OnSequenceStart(const Mark&, const std::string&, anchor_t,
+                               YAML::EmitterStyle::value) {}
+  virtual void OnSequenceEnd() {}
+  virtual void OnMapStart(const Mark&, const std::string&, anchor_t,
+                          YAML::EmitterStyle::value) {}
+  virtual void OnMapEnd() {}
+};
+
+std::string make_words(std::size_t length) {
+  std::string words;
+  while (words.size() < length)
+    words += "lorem ipsum-dolor sit_amet 12.5e3 ";
+  words.resize(length);
+  return words + "end";
+}
+
+std::string make_numbers(std::size_t length) {
+  std::string numbers;
+  for (int i = 0; numbers.size() < length; i++)
+    numbers += std::to_string(i * 0.25 - 1000) + " ";
+  numbers.resize(length);
+  return numbers + "0";
+}
+
+std::string make_document(const std::string& words, std::size_t scalars) {
+  std::string doc = "[";
+  for (std::size_t i = 0; i < scalars; i++) {
+    switch (i % 3) {
+      case 0:
+        doc += words;
+        break;
+      case 1:
+        doc += "'" + words + "'";
+        break;
+      case 2:
+        doc += "\"" + words + "\"";
+        break;
+    }
+    doc += ",\n ";
+  }
+  return doc + "]\n";
+}
+
+// Returns the best time to parse 'doc', in seconds.
+double time_parse(const std::string& doc, int runs) {
+  double best = 0;
+  for (int i = 0; i < runs; i++) {
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    YAML::Parser parser(doc.data(), doc.size());
+    NullEventHandler handler;
+    parser.HandleNextDocument(handler);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (i == 0 || elapsed.count() < best)
+      best = elapsed.count();
+  }
+  return best;
+}
+
+void report(const char* name, const std::string& doc, int runs) {
+  double best = time_parse(doc, runs);
+  std::cout << name << ": " << doc.size() / 1e6 << " MB in " << best * 1e3
+            << " ms, " << doc.size() / 1e6 / best << " MB/s\n";
+}
+}
+
+int main(int argc, char** argv) {
+  int runs = argc > 1 ? std::atoi(argv[1]) : 5;
+  report("text", make_document(make_words(4000), 3000), runs);
+  report("numbers", make_document(make_numbers(4000), 3000), runs);
+  return 0;
+}
@@ -18,6 +18,15 @@ class HandlerTest : public ::testing::Test {
     }
   }
 
+  // Parses from a copy of the bytes with no terminator after them, so that
+  // reading past the end shows up under a memory checker.
+  void ParseBuffer(const std::string& example) {
+    std::vector<char> buffer(example.begin(), example.end());
+    Parser parser(buffer.data(), buffer.size());
+    while (parser.HandleNextDocument(handler)) {
+    }
+  }
+
   void IgnoreParse(const std::string& example) {
     std::stringstream stream(example);
     Parser parser(stream);
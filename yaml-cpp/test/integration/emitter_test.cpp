@@ -1,3 +1,8 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
 #include "yaml-cpp/emitterstyle.h"
 #include "yaml-cpp/eventhandler.h"
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
@@ -925,6 +930,119 @@ TEST_F(EmitterTest, HexAndOct) {
   ExpectEmit("[31, 0x1f, 037]");
 }
 
+TEST_F(EmitterTest, FlowSeqOfInts) {
+  const int values[] = {0, 1, -2, std::numeric_limits<int>::max(),
+                        std::numeric_limits<int>::min()};
+  out.WriteFlowSeq(values, 5);
+
+  ExpectEmit("[0, 1, -2, 2147483647, -2147483648]");
+}
+
+TEST_F(EmitterTest, FlowSeqOfUnsignedLongLongs) {
+  const unsigned long long values[] = {
+      7, std::numeric_limits<unsigned long long>::max()};
+  out.WriteFlowSeq(values, 2);
+
+  ExpectEmit("[7, 18446744073709551615]");
+}
+
+TEST_F(EmitterTest, FlowSeqOfDoubles) {
+  const double values[] = {0.1,    -1.5,   1e21,   1e-7,
+                           100.0,  -0.0,   0.3,    5e-324,
+                           1e23,   8.41e21, 1.7976931348623157e308};
+  out.WriteFlowSeq(values, 11);
+
+  ExpectEmit(
+      "[0.1, -1.5, 1e+21, 1e-07, 100, -0, 0.3, 5e-324, 1e+23, 8.41e+21, "
+      "1.7976931348623157e+308]");
+}
+
+TEST_F(EmitterTest, FlowSeqOfFloats) {
+  const float values[] = {0.1f, 1.234f, 3.4028235e38f, 16777216.0f};
+  out.WriteFlowSeq(values, 4);
+
+  ExpectEmit("[0.1, 1.234, 3.4028235e+38, 16777216]");
+}
+
+TEST_F(EmitterTest, FlowSeqOfSpecialDoubles) {
+  const double values[] = {std::numeric_limits<double>::quiet_NaN(),
+                           std::numeric_limits<double>::infinity(),
+                           -std::numeric_limits<double>::infinity()};
+  out.WriteFlowSeq(values, 3);
+
+  ExpectEmit("[.nan, .inf, -.inf]");
+}
+
+TEST_F(EmitterTest, FlowSeqIgnoresPrecision) {
+  const float floats[] = {1.234f};
+  const double doubles[] = {0.1 + 0.2};
+  out << FloatPrecision(3) << DoublePrecision(3);
+  out << BeginSeq;
+  out.WriteFlowSeq(floats, 1);
+  out.WriteFlowSeq(doubles, 1);
+  out << EndSeq;
+
+  ExpectEmit("- [1.234]\n- [0.30000000000000004]");
+}
+
+TEST_F(EmitterTest, FlowSeqKeepsIntBase) {
+  const int values[] = {16, 255};
+  out << Hex;
+  out.WriteFlowSeq(values, 2);
+
+  ExpectEmit("[0x10, 0xff]");
+}
+
+TEST_F(EmitterTest, FlowSeqMatchesSeqOfNumbers) {
+  const int values[] = {1, 2, 3};
+  Emitter expected;
+  expected << BeginMap;
+  expected << Key << "a" << Value << Flow << BeginSeq << 1 << 2 << 3 << EndSeq;
+  expected << Key << "b" << Value << Anchor("b") << Flow << BeginSeq << EndSeq;
+  expected << Key << Flow << BeginSeq << 1 << 2 << 3 << EndSeq;
+  expected << Value << BeginSeq;
+  expected << Flow << BeginSeq << 1 << 2 << 3 << EndSeq;
+  expected << Comment("empty") << Flow << BeginSeq << EndSeq;
+  expected << Flow << BeginMap << Key << "c" << Value << Flow << BeginSeq << 1
+           << 2 << 3 << EndSeq << EndMap;
+  expected << EndSeq;
+  expected << EndMap;
+
+  out << BeginMap;
+  out << Key << "a" << Value;
+  out.WriteFlowSeq(values, 3);
+  out << Key << "b" << Value << Anchor("b");
+  out.WriteFlowSeq(values, 0);
+  out << Key;
+  out.WriteFlowSeq(values, 3);
+  out << Value << BeginSeq;
+  out.WriteFlowSeq(values, 3);
+  out << Comment("empty");
+  out.WriteFlowSeq(values, 0);
+  out << Flow << BeginMap << Key << "c" << Value;
+  out.WriteFlowSeq(values, 3);
+  out << EndMap;
+  out << EndSeq;
+  out << EndMap;
+
+  ExpectEmit(expected.c_str());
+}
+
+TEST_F(EmitterTest, FlowSeqOfDoublesReadsBack) {
+  std::mt19937_64 random(1);
+  std::uniform_real_distribution<double> mantissa(-1, 1);
+  std::uniform_int_distribution<int> exponent(-300, 300);
+  std::vector<double> values;
+  for (int i = 0; i < 1000; i++)
+    values.push_back(mantissa(random) * std::pow(10.0, exponent(random)));
+  out.WriteFlowSeq(values.data(), values.size());
+
+  Node node = Load(out.c_str());
+  ASSERT_EQ(values.size(), node.size());
+  for (std::size_t i = 0; i < values.size(); i++)
+    EXPECT_EQ(values[i], node[i].as<double>());
+}
+
 TEST_F(EmitterTest, CompactMapWithNewline) {
   out << Comment("Characteristics");
   out << BeginSeq;
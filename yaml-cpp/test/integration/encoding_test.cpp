@@ -92,7 +92,7 @@ class EncodingTest : public HandlerTest {
     m_yaml.seekg(0, std::ios::beg);
   }
 
-  void Run() {
+  void Run(bool fromBuffer = false) {
     InSequence sequence;
     EXPECT_CALL(handler, OnDocumentStart(_));
     EXPECT_CALL(handler, OnSequenceStart(_, "?", 0, EmitterStyle::Block));
@@ -102,7 +102,10 @@ class EncodingTest : public HandlerTest {
     EXPECT_CALL(handler, OnSequenceEnd());
     EXPECT_CALL(handler, OnDocumentEnd());
 
-    Parse(m_yaml.str());
+    if (fromBuffer)
+      ParseBuffer(m_yaml.str());
+    else
+      Parse(m_yaml.str());
   }
 
  private:
@@ -178,5 +181,34 @@ TEST_F(EncodingTest, UTF32BE_BOM) {
   SetUpEncoding(&EncodeToUtf32BE, true);
   Run();
 }
+TEST_F(EncodingTest, UTF8_noBOM_Buffer) {
+  SetUpEncoding(&EncodeToUtf8, false);
+  Run(true);
+}
+
+TEST_F(EncodingTest, UTF8_BOM_Buffer) {
+  SetUpEncoding(&EncodeToUtf8, true);
+  Run(true);
+}
+
+TEST_F(EncodingTest, UTF16LE_noBOM_Buffer) {
+  SetUpEncoding(&EncodeToUtf16LE, false);
+  Run(true);
+}
+
+TEST_F(EncodingTest, UTF16BE_BOM_Buffer) {
+  SetUpEncoding(&EncodeToUtf16BE, true);
+  Run(true);
+}
+
+TEST_F(EncodingTest, UTF32LE_BOM_Buffer) {
+  SetUpEncoding(&EncodeToUtf32LE, true);
+  Run(true);
+}
+
+TEST_F(EncodingTest, UTF32BE_noBOM_Buffer) {
+  SetUpEncoding(&EncodeToUtf32BE, false);
+  Run(true);
+}
 }
 }
@@ -185,6 +185,249 @@ TEST(LoadNodeTest, DereferenceIteratorError) {
   EXPECT_THROW(node.begin()->begin()->Type(), InvalidNode);
 }
 
+TEST(LoadNodeTest, LoadedNodeOutlivesDocument) {
+  Node item;
+  {
+    Node doc = Load("items: [{type: rect, bounds: [1, 2, 3, 4]}]");
+    item = doc["items"][0];
+  }
+  EXPECT_EQ("rect", item["type"].as<std::string>());
+  EXPECT_EQ(4, item["bounds"][3].as<int>());
+}
+
+TEST(LoadNodeTest, AssignLoadedIntoBuiltNode) {
+  Node built;
+  built["before"] = 1;
+  {
+    Node doc = Load("{a: [1, 2], b: &x foo, c: *x}");
+    built["doc"] = doc;
+    built["c"] = doc["c"];
+  }
+  built["after"] = 2;
+  EXPECT_EQ(2, built["doc"]["a"][1].as<int>());
+  EXPECT_EQ("foo", built["c"].as<std::string>());
+  EXPECT_EQ(2, built["after"].as<int>());
+}
+
+TEST(LoadNodeTest, AssignBuiltIntoLoadedNode) {
+  Node doc = Load("{a: 1}");
+  {
+    Node built;
+    built["x"] = "y";
+    built["list"].push_back(3);
+    doc["built"] = built;
+  }
+  doc["more"]["nested"] = "value";
+  EXPECT_EQ("y", doc["built"]["x"].as<std::string>());
+  EXPECT_EQ(3, doc["built"]["list"][0].as<int>());
+  EXPECT_EQ("value", doc["more"]["nested"].as<std::string>());
+}
+
+TEST(LoadNodeTest, MergeLoadedDocuments) {
+  Node first = Load("{a: 1}");
+  {
+    Node second = Load("{b: [2, 3]}");
+    Node third = Load("{c: 4}");
+    second["third"] = third;
+    first["second"] = second;
+    third["c"] = 5;
+  }
+  EXPECT_EQ(3, first["second"]["b"][1].as<int>());
+  EXPECT_EQ(5, first["second"]["third"]["c"].as<int>());
+}
+
+TEST(LoadNodeTest, MergeLoadedDocumentsInACycle) {
+  // Under LSan this also checks that the merged arenas are freed.
+  Node d0 = Load("[0]");
+  Node d1 = Load("[1]");
+  d1.push_back(d0);
+  Node d2 = Load("[2]");
+  d2.push_back(d1);
+  d0.push_back(d2);
+  EXPECT_EQ(1, d0[1][1][0].as<int>());
+  EXPECT_EQ(0, d0[1][1][1][0].as<int>());
+}
+
+TEST(LoadNodeTest, WideMapKeyChangedThroughAlias) {
+  Node node = Load(
+      "{a: 0, b: 1, c: 2, d: 3, e: 4, f: 5, g: 6, &k h: 7, list: [*k]}");
+  EXPECT_EQ(7, node["h"].as<int>());
+  node["list"][0] = "renamed";
+  EXPECT_EQ(7, node["renamed"].as<int>());
+  EXPECT_FALSE(node["h"]);
+}
+
+TEST(LoadNodeTest, WideMapsSharingAKey) {
+  Node node = Load(
+      "{x: {a: 0, b: 1, c: 2, d: 3, e: 4, f: 5, g: 6, &k h: 7}, "
+      "y: {a: 0, b: 1, c: 2, d: 3, e: 4, f: 5, g: 6, *k : 8}, "
+      "z: {a: 0, b: 1, c: 2, d: 3, e: 4, f: 5, g: 6, h: 9}, list: [*k]}");
+  EXPECT_EQ(7, node["x"]["h"].as<int>());
+  EXPECT_EQ(8, node["y"]["h"].as<int>());
+  EXPECT_EQ(9, node["z"]["h"].as<int>());
+  node["list"][0] = "renamed";
+  EXPECT_EQ(7, node["x"]["renamed"].as<int>());
+  EXPECT_EQ(8, node["y"]["renamed"].as<int>());
+  EXPECT_FALSE(node["x"]["h"]);
+  EXPECT_FALSE(node["y"]["h"]);
+  EXPECT_EQ(9, node["z"]["h"].as<int>());
+}
+
+// Scalars in a string are scanned in bulk, and those in a stream one
+// character at a time; both should give the same result.
+TEST(LoadNodeTest, LongScalarsMatchStreamLoading) {
+  const char* specials[] = {":", ": ", " #", "#", "\\n", "\\\"", "''",
+                            "\\t", ",", "]", "\t", "\x04"};
+  for (std::size_t length = 1; length < 80; length += 7) {
+    for (const char* special : specials) {
+      std::string text(length, 'x');
+      text.insert(length / 2, special);
+      std::string yaml = "- [" + text + ", '" + text + "', \"" + text +
+                         "\", {k: " + text + "}]\n- " + text + "\n";
+      std::stringstream stream(yaml);
+      Node fromString;
+      Node fromStream;
+      std::string stringError;
+      std::string streamError;
+      try {
+        fromString = Load(yaml);
+      } catch (const Exception& e) {
+        stringError = e.what();
+      }
+      try {
+        fromStream = Load(stream);
+      } catch (const Exception& e) {
+        streamError = e.what();
+      }
+      EXPECT_EQ(streamError, stringError) << yaml;
+      EXPECT_EQ(Dump(fromStream), Dump(fromString)) << yaml;
+    }
+  }
+}
+
+TEST(LoadNodeTest, LoadAllParallelMatchesLoadAll) {
+  const char* inputs[] = {
+      "",
+      "a",
+      "---\na\n---\nb\n---\n",
+      "# frames\n--- &x [1, *x]\n--- {a: &x 2, b: *x}\n---\n- c\n- d\n",
+      "a\n...\nb\n---\nc\n...\n",
+      "--- |\n  one\n---\n>\n two\n--- |\nthree\n---\nfour\n",
+      "\xEF\xBB\xBF---\na: 1\r\n---\r\nb: 2\r\n---\tc\n",
+      "---a\n----\n -- x\n--- y\n",
+      "%YAML 1.2\n--- a\n%TAG ! !foo\n--- !x b\n",
+      "a: 'foo\n---\nbar'\n",
+      "a: \"foo\n---\nbar\"\n",
+      "- 'a\n---\n- b\n",
+      "[a,\n---\nb]\n",
+  };
+  // The documents, dumped with their marks, or the error.
+  auto load = [](const std::string& input, bool parallel) {
+    std::vector<std::string> result;
+    try {
+      std::vector<Node> docs =
+          parallel ? LoadAllParallel(input, 4) : LoadAll(input);
+      for (const Node& doc : docs)
+        result.push_back(Dump(doc) + " @" + std::to_string(doc.Mark().pos) +
+                         "," + std::to_string(doc.Mark().line) + "," +
+                         std::to_string(doc.Mark().column));
+    } catch (const ParserException& e) {
+      result.push_back(std::string("error: ") + e.what());
+    }
+    return result;
+  };
+  for (const char* input : inputs)
+    EXPECT_EQ(load(input, false), load(input, true)) << input;
+}
+
+TEST(LoadNodeTest, LoadAllParallelKeepsDocumentsApart) {
+  std::string input;
+  for (int i = 0; i < 100; i++)
+    input += "--- {frame: " + std::to_string(i) + ", items: [a, b, c]}\n";
+  std::vector<Node> docs = LoadAllParallel(input, 8);
+  ASSERT_EQ(100u, docs.size());
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(i, docs[i]["frame"].as<int>());
+    EXPECT_EQ(i, docs[i].Mark().line);
+  }
+  docs[0]["items"] = docs[1]["items"];
+  docs.erase(docs.begin() + 1);
+  EXPECT_EQ("c", docs[0]["items"][2].as<std::string>());
+}
+
+TEST(LoadNodeTest, LoadAllParallelThrowsFirstError) {
+  const char* input = "a\n---\nb: [c\n---\nd\n---\n'e\n";
+  Mark mark;
+  try {
+    LoadAll(input);
+    FAIL() << "LoadAll should throw";
+  } catch (const ParserException& e) {
+    mark = e.mark;
+  }
+  try {
+    LoadAllParallel(input, 4);
+    FAIL() << "LoadAllParallel should throw";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(mark.pos, e.mark.pos);
+    EXPECT_EQ(mark.line, e.mark.line);
+    EXPECT_EQ(mark.column, e.mark.column);
+  }
+}
+
+TEST(LoadNodeTest, StdVectorOfNumbersWithSpecialValues) {
+  Node node = Load("[1.5, -2, .inf, '3 ']");
+  std::vector<double> values = node.as<std::vector<double>>();
+  ASSERT_EQ(4u, values.size());
+  EXPECT_EQ(1.5, values[0]);
+  EXPECT_EQ(-2, values[1]);
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), values[2]);
+  EXPECT_EQ(3, values[3]);
+}
+
+TEST(LoadNodeTest, StdVectorOfNumbersWithBadElement) {
+  Node node = Load("[1, 2, x]");
+  EXPECT_THROW(node.as<std::vector<int>>(), TypedBadConversion<int>);
+}
+
+TEST(LoadNodeTest, DecodeNumbersFromSequence) {
+  std::vector<double> values(10, 0.0);
+  ASSERT_TRUE(DecodeNumbers(Load("[3, -0.25, 1e-3, 12.5E2, 0.1]"), values));
+  EXPECT_EQ((std::vector<double>{3.0, -0.25, 0.001, 1250.0, 0.1}), values);
+
+  std::vector<int> ints;
+  ASSERT_TRUE(DecodeNumbers(Load("[+7, -0, 0x1F, 010]"), ints));
+  EXPECT_EQ((std::vector<int>{7, 0, 31, 8}), ints);
+}
+
+TEST(LoadNodeTest, DecodeNumbersFromScalar) {
+  Node node = Load("bounds: 1 2.5\n  -3 4");
+  std::vector<float> bounds;
+  ASSERT_TRUE(DecodeNumbers(node["bounds"], bounds));
+  EXPECT_EQ((std::vector<float>{1.0f, 2.5f, -3.0f, 4.0f}), bounds);
+
+  int buffer[3];
+  EXPECT_TRUE(DecodeNumbers(Node("7 8 9"), buffer, 3));
+  EXPECT_EQ(9, buffer[2]);
+  EXPECT_FALSE(DecodeNumbers(Node("7 8"), buffer, 3));
+  EXPECT_FALSE(DecodeNumbers(Node("7 8 9 10"), buffer, 3));
+  EXPECT_FALSE(DecodeNumbers(Node("7 eight 9"), buffer, 3));
+}
+
+TEST(LoadNodeTest, DecodeNumbersOutOfRange) {
+  std::vector<short> shorts;
+  EXPECT_TRUE(DecodeNumbers(Node("-32768 32767"), shorts));
+  EXPECT_FALSE(DecodeNumbers(Node("32768"), shorts));
+  std::vector<unsigned> unsigneds;
+  EXPECT_TRUE(DecodeNumbers(Node("4294967295"), unsigneds));
+  EXPECT_FALSE(DecodeNumbers(Node("4294967296"), unsigneds));
+}
+
+TEST(LoadNodeTest, DecodeNumbersFromMap) {
+  std::vector<int> values;
+  EXPECT_FALSE(DecodeNumbers(Load("{a: 1}"), values));
+  EXPECT_FALSE(DecodeNumbers(Load("[1, [2]]"), values));
+}
+
 TEST(NodeTest, EmitEmptyNode) {
   Node node;
   Emitter emitter;
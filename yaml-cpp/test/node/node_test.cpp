@@ -107,6 +107,68 @@ TEST(NodeTest, MapForceInsert) {
   EXPECT_EQ(3, node.size());
 }
 
+// Maps this wide are looked up through a hash index over their keys.
+TEST(NodeTest, WideMapLookup) {
+  Node node;
+  for (int i = 0; i < 100; i++)
+    node["key" + std::to_string(i)] = i;
+  EXPECT_EQ(100, node.size());
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(i, node["key" + std::to_string(i)].as<int>());
+  EXPECT_FALSE(node["missing"]);
+  EXPECT_EQ(100, node.size());
+
+  const Node& constNode = node;
+  EXPECT_EQ(42, constNode["key42"].as<int>());
+  EXPECT_FALSE(constNode["other"]);
+}
+
+TEST(NodeTest, WideMapDuplicateKeysFindFirst) {
+  Node node;
+  for (int i = 0; i < 20; i++)
+    node.force_insert("k" + std::to_string(i % 10), i);
+  for (int i = 0; i < 10; i++)
+    EXPECT_EQ(i, node["k" + std::to_string(i)].as<int>());
+}
+
+TEST(NodeTest, WideMapNonScalarKeys) {
+  Node node;
+  for (int i = 0; i < 20; i++)
+    node[i] = i;
+  Node seqKey;
+  seqKey.push_back("key5");
+  node[seqKey] = "seq";
+  EXPECT_EQ(5, node["5"].as<int>());
+  EXPECT_EQ(5, node[5].as<int>());
+  EXPECT_FALSE(node["key5"]);
+}
+
+TEST(NodeTest, WideMapKeyChangedThroughIterator) {
+  Node node;
+  for (int i = 0; i < 20; i++)
+    node["k" + std::to_string(i)] = i;
+  EXPECT_EQ(3, node["k3"].as<int>());
+
+  for (iterator it = node.begin(); it != node.end(); ++it) {
+    if (it->first.as<std::string>() == "k3")
+      it->first = "renamed";
+  }
+  EXPECT_EQ(3, node["renamed"].as<int>());
+  EXPECT_EQ(20, node.size());
+  EXPECT_FALSE(node["k3"]);
+}
+
+TEST(NodeTest, WideMapRemove) {
+  Node node;
+  for (int i = 0; i < 20; i++)
+    node["k" + std::to_string(i)] = i;
+  EXPECT_EQ(10, node["k10"].as<int>());
+  EXPECT_TRUE(node.remove("k5"));
+  EXPECT_FALSE(node["k5"]);
+  EXPECT_EQ(10, node["k10"].as<int>());
+  EXPECT_EQ(19, node["k19"].as<int>());
+}
+
 TEST(NodeTest, UndefinedConstNodeWithFallback) {
   Node node;
   const Node& cn = node;
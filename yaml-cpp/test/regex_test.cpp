@@ -174,4 +174,34 @@ TEST(RegExTest, StringOr) {
 
   EXPECT_EQ(1, ex.Match(str));
 }
+TEST(RegExTest, OperatorNotOfSequence) {
+  RegEx ex = !RegEx(std::string("ab"));
+
+  EXPECT_EQ(-1, ex.Match(std::string("ab")));
+  EXPECT_EQ(1, ex.Match(std::string("ac")));
+  EXPECT_EQ(1, ex.Match(std::string("x")));
+}
+
+TEST(RegExTest, HighBitRange) {
+  RegEx ex = RegEx('\xC2') + RegEx('\x80', '\x84');
+
+  EXPECT_EQ(2, ex.Match(std::string("\xC2\x80")));
+  EXPECT_EQ(2, ex.Match(std::string("\xC2\x84")));
+  EXPECT_EQ(-1, ex.Match(std::string("\xC2\x85")));
+  EXPECT_EQ(-1, ex.Match(std::string("\xC3\x80")));
+  EXPECT_EQ(-1, ex.Match(std::string("\xC2" "a")));
+}
+
+TEST(RegExTest, CharacterClassesAgreeWithTheirDefinition) {
+  RegEx digit('0', '9');
+  RegEx notDigitOrA = !(digit || RegEx('a'));
+  RegEx lowerHex = RegEx('a', 'z') && RegEx("abcdef", YAML::REGEX_OR);
+
+  for (int i = MIN_CHAR; i < 256; ++i) {
+    auto str = std::string(1, char(i));
+    bool isDigit = '0' <= i && i <= '9';
+    EXPECT_EQ(isDigit || i == 'a' ? -1 : 1, notDigitOrA.Match(str));
+    EXPECT_EQ('a' <= i && i <= 'f' ? 1 : -1, lowerHex.Match(str));
+  }
+}
 }
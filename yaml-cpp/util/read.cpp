@@ -27,13 +27,30 @@ class NullEventHandler : public YAML::EventHandler {
   virtual void OnMapEnd() {}
 };
 
-void run(std::istream& in) {
+void run(std::istream& in, bool load) {
+  if (load) {
+    // Builds the node graph as well, and frees it again.
+    YAML::Node doc = YAML::Load(in);
+    return;
+  }
   YAML::Parser parser(in);
   NullEventHandler handler;
   parser.HandleNextDocument(handler);
 }
 
-void usage() { std::cerr << "Usage: read [-n N] [-c, --cache] [filename]\n"; }
+void run(const std::string& input, bool load) {
+  if (load) {
+    YAML::Node doc = YAML::Load(input);
+    return;
+  }
+  YAML::Parser parser(input.data(), input.size());
+  NullEventHandler handler;
+  parser.HandleNextDocument(handler);
+}
+
+void usage() {
+  std::cerr << "Usage: read [-n N] [-c, --cache] [-l, --load] [filename]\n";
+}
 
 std::string read_stream(std::istream& in) {
   return std::string((std::istreambuf_iterator<char>(in)),
@@ -43,6 +60,7 @@ std::string read_stream(std::istream& in) {
 int main(int argc, char** argv) {
   int N = 1;
   bool cache = false;
+  bool load = false;
   std::string filename;
   for (int i = 1; i < argc; i++) {
     std::string arg = argv[i];
@@ -59,6 +77,8 @@ int main(int argc, char** argv) {
       }
     } else if (arg == "-c" || arg == "--cache") {
       cache = true;
+    } else if (arg == "-l" || arg == "--load") {
+      load = true;
     } else {
       filename = argv[i];
       if (i + 1 != argc) {
@@ -81,21 +101,19 @@ int main(int argc, char** argv) {
     } else {
       input = read_stream(std::cin);
     }
-    std::istringstream in(input);
     for (int i = 0; i < N; i++) {
-      in.seekg(std::ios_base::beg);
-      run(in);
+      run(input, load);
     }
   } else {
     if (filename != "") {
       std::ifstream in(filename);
       for (int i = 0; i < N; i++) {
         in.seekg(std::ios_base::beg);
-        run(in);
+        run(in, load);
       }
     } else {
       for (int i = 0; i < N; i++) {
-        run(std::cin);
+        run(std::cin, load);
       }
     }
   }
@@ -30,6 +30,9 @@
 #include "BoxBorderPainter.h"
 #include "GraphicsContext.h"
 #include "ComputedStyle.h"
+#include "ObjectPainter.h"
+#include "CountingCanvas.h"
+#include "BorderGeometryBatch.h"
 using namespace std;
 
 // SkColor is typdef to unsigned int so we wrap
@@ -246,8 +249,7 @@ void broadcast(vector<T> &v, int num_items)
     }
 }
 
-void drawBorder(SkCanvas *c, YAML::Node &item) {
-    using namespace blink;
+void readBorder(YAML::Node &item, blink::ComputedStyle &style, blink::LayoutRect &borderRect) {
     SkRect bounds;
     if (item["rect"])
             bounds = item["rect"].as<SkRect>();
@@ -274,8 +276,6 @@ void drawBorder(SkCanvas *c, YAML::Node &item) {
         auto color = item["color"].as<SkColorW>().color;
     } else {
 */
-    blink::GraphicsContext context(c);
-    blink::PaintInfo info(context);
     blink::ComputedStyle::BorderData b;
 
     b.m_topWidth = widths[0];
@@ -302,14 +302,44 @@ void drawBorder(SkCanvas *c, YAML::Node &item) {
         b.m_bottomRight = radius.bottom_right;
     }
 
-    blink::ComputedStyle style;
     style.m_border = b;
-    blink::LayoutRect borderRect = bounds;
+    borderRect = bounds;
+}
+
+void drawBorder(SkCanvas *c, YAML::Node &item) {
+    using namespace blink;
+    blink::ComputedStyle style;
+    blink::LayoutRect borderRect;
+    readBorder(item, style, borderRect);
+
+    blink::GraphicsContext context(c);
+    blink::PaintInfo info(context);
     BoxBorderPainter painter(borderRect, style, blink::BackgroundBleedNone,
                              true, true);
     painter.paintBorder(info, borderRect);
 }
 
+void drawOutline(SkCanvas *c, YAML::Node &item) {
+    using namespace blink;
+    vector<IntRect> rects;
+    for (auto r : item["rects"]) {
+        SkRect rect = r.as<SkRect>();
+        rects.push_back(IntRect(lroundf(rect.x()), lroundf(rect.y()),
+                                lroundf(rect.width()), lroundf(rect.height())));
+    }
+
+    ComputedStyle style;
+    style.m_outline.m_width = item["width"].as<int>();
+    if (item["offset"])
+        style.m_outline.m_offset = item["offset"].as<int>();
+    style.m_outline.m_style = YAML::toStyle(item["style"].as<string>());
+    style.m_outline.m_color = item["color"].as<SkColorW>().color;
+
+    GraphicsContext context(c);
+    PaintInfo info(context);
+    ObjectPainter::paintOutlineRects(info, rects, style, style.outlineColor());
+}
+
 void drawGlyphs(SkCanvas *c, YAML::Node &item) {
     // XXX: handle bounds
     vector<uint16_t> indices;
@@ -359,36 +389,59 @@ void drawImage(SkCanvas *c, YAML::Node &node) {
     sk_sp<SkImage> img = GetResourceAsImage(path.c_str());
     c->drawImage(img, bounds[0], bounds[1]);
 }
-void drawItem(SkCanvas *c, YAML::Node &node);
+void drawItems(SkCanvas *c, YAML::Node items);
 void drawStackingContext(SkCanvas *c, YAML::Node &node) {
     auto bounds = node["bounds"].as<vector<double>>();
     c->save();
     c->translate(bounds[0], bounds[1]);
-    for (auto i : node["items"]) {
-        drawItem(c, i);
-    }
+    drawItems(c, node["items"]);
     c->restore();
 }
 
 
+// When set, the canvas calls made by each item are attributed to its type.
+static blink::CountingCanvas *gItemCounter = nullptr;
+
+void setYAMLItemCounter(blink::CountingCanvas *counter) {
+    gItemCounter = counter;
+}
+
+struct ItemCountScope {
+    ItemCountScope(const string &type) {
+        if (gItemCounter)
+            gItemCounter->beginItem(type);
+    }
+    ~ItemCountScope() {
+        if (gItemCounter)
+            gItemCounter->endItem();
+    }
+};
+
 void drawItem(SkCanvas *c, YAML::Node &node) {
     if (node["text"]) {
+        ItemCountScope scope("text");
         drawText(c, node);
     } else if (node["rect"]) {
+        ItemCountScope scope("rect");
         drawRect(c, node);
     } else if (node["image"]) {
+        ItemCountScope scope("image");
         drawImage(c, node);
     } else if (node["glyphs"]) {
+        ItemCountScope scope("glyphs");
         drawGlyphs(c, node);
     } else if (node["stacking_context"]) {
     } else if (node["type"]) {
         auto type = node["type"].as<string>();
+        ItemCountScope scope(type);
         if (type == "stacking_context") {
             drawStackingContext(c, node);
         } else if (type == "rect") {
             drawRect(c, node);
         } else if (type == "border") {
             drawBorder(c, node);
+        } else if (type == "outline") {
+            drawOutline(c, node);
         }
 
     }
@@ -396,6 +449,57 @@ void drawItem(SkCanvas *c, YAML::Node &node) {
 }
 
 
+// Consecutive border items are read first and painted together, so that their
+// rounded rects can be computed in one BorderGeometryBatch pass.
+struct BorderRun {
+    vector<blink::ComputedStyle> styles;
+    vector<blink::LayoutRect> rects;
+    blink::BorderGeometryBatch geometry;
+};
+
+static bool isBorderItem(YAML::Node &node) {
+    if (node["text"] || node["rect"] || node["image"] || node["glyphs"] || node["stacking_context"])
+        return false;
+    return node["type"] && node["type"].as<string>() == "border";
+}
+
+static void drawBorderRun(SkCanvas *c, BorderRun &run) {
+    if (run.styles.empty())
+        return;
+
+    run.geometry.clear();
+    for (size_t i = 0; i < run.styles.size(); i++)
+        run.geometry.add(run.rects[i], run.styles[i]);
+    run.geometry.compute();
+
+    blink::GraphicsContext context(c);
+    blink::PaintInfo info(context);
+    for (size_t i = 0; i < run.styles.size(); i++) {
+        ItemCountScope scope("border");
+        blink::BoxBorderPainter painter(run.styles[i], blink::BackgroundBleedNone,
+                                        run.geometry.outer(i), run.geometry.inner(i));
+        painter.paintBorder(info, run.rects[i]);
+    }
+
+    run.styles.clear();
+    run.rects.clear();
+}
+
+void drawItems(SkCanvas *c, YAML::Node items) {
+    BorderRun run;
+    for (auto i : items) {
+        if (isBorderItem(i)) {
+            run.styles.push_back(blink::ComputedStyle());
+            run.rects.push_back(blink::LayoutRect());
+            readBorder(i, run.styles.back(), run.rects.back());
+            continue;
+        }
+        drawBorderRun(c, run);
+        drawItem(c, i);
+    }
+    drawBorderRun(c, run);
+}
+
 YAML::Node loadYAMLFile(const char *filename_raw) {
     string filename(filename_raw);
     auto last_slash = filename.find_last_of("/\\");
@@ -409,8 +513,6 @@ YAML::Node loadYAMLFile(const char *filename_raw) {
 }
 
 void drawYAMLFile(YAML::Node &doc, SkCanvas *canvas) {
-    for (auto i : doc["root"]["items"]) {
-        drawItem(canvas, i);
-    }
+    drawItems(canvas, doc["root"]["items"]);
 }
 